@@ -29,6 +29,7 @@
 #include "storage_manager.h"
 #include "system_state.h"
 #include "time_manager.h"
+#include "timer_wheel.h"
 #include "ui_manager.h"
 #include "wifi_manager.h"
 
@@ -77,8 +78,8 @@ static void ui_task(void *pvParameters) {
   LOG_INFO(TAG, "UI task started");
 
   while (1) {
+    ui_manager_wait_redraw(); // Sleeps until something needs drawing
     ui_manager_update();
-    vTaskDelay(pdMS_TO_TICKS(33)); // ~30 FPS
   }
 }
 
@@ -95,79 +96,123 @@ static void input_task(void *pvParameters) {
 }
 
 // =============================================================================
-// Network Task - Handles API communication
+// Network Task - Runs scheduled API work
 // =============================================================================
-static void network_task(void *pvParameters) {
-  TickType_t last_heartbeat = xTaskGetTickCount();
-  TickType_t last_bind_check = 0;
-  TickType_t last_settings_fetch = 0;
-  TickType_t last_ota_check = 0;
-  bool bind_code_requested = false;
-  char bind_code[5] = {0};
 
-  while (1) {
-    calx_state_t state = system_state_get();
-
-    // Handle not bound state - request bind code once
-    if (state == STATE_NOT_BOUND && !bind_code_requested &&
-        wifi_manager_is_connected()) {
-      int expires_in;
-      if (api_client_request_bind_code(bind_code, &expires_in)) {
-        ui_manager_show_bind_code(bind_code);
-        system_state_set(STATE_BIND);
-        bind_code_requested = true;
-        last_bind_check = xTaskGetTickCount();
-        LOG_INFO(TAG, "Bind code displayed: %s", bind_code);
-      }
-    }
+// Periodic API request that needs a bound, connected device
+typedef struct {
+  wheel_timer_t timer;
+  uint32_t period_ms;
+  uint32_t jitter_ms;
+  bool (*run)(void);
+} network_job_t;
+
+static wheel_timer_t bind_timer;
+static event_listener_t wifi_listener;
+static event_listener_t unbound_listener;
+static bool bind_code_requested = false;
+
+static bool check_update(void) {
+  update_info_t info;
+  if (!api_client_check_update(&info)) {
+    return false;
+  }
+  LOG_INFO(TAG, "OTA update available: %s", info.version);
+  return true;
+}
 
-    // Poll bind status every 5 seconds when in bind state
-    if (state == STATE_BIND) {
-      TickType_t now = xTaskGetTickCount();
-      if ((now - last_bind_check) >= pdMS_TO_TICKS(5000)) {
-        char token[128];
-        if (api_client_check_bind_status(token)) {
-          // Device is now bound!
-          security_manager_set_token(token);
-          LOG_INFO(TAG, "Device bound successfully!");
-          system_state_set(STATE_IDLE);
-          bind_code_requested = false; // Reset for next time
-        }
-        last_bind_check = now;
-      }
-    }
+// First runs one period after boot
+static network_job_t network_jobs[] = {
+    {.period_ms = HEARTBEAT_NORMAL_INTERVAL_MS,
+     .jitter_ms = HEARTBEAT_JITTER_MS,
+     .run = api_client_send_heartbeat},
+    {.period_ms = SETTINGS_FETCH_INTERVAL_MS,
+     .jitter_ms = SETTINGS_FETCH_JITTER_MS,
+     .run = api_client_fetch_settings},
+    {.period_ms = OTA_CHECK_INTERVAL_MS,
+     .jitter_ms = OTA_CHECK_JITTER_MS,
+     .run = check_update},
+};
+
+#define NETWORK_JOB_COUNT (sizeof(network_jobs) / sizeof(network_jobs[0]))
+
+static void run_network_job(void *arg) {
+  network_job_t *job = arg;
+  if (!security_manager_is_bound() || !wifi_manager_is_connected()) {
+    // Try again soon rather than a whole period later
+    timer_wheel_start(&job->timer, NETWORK_RETRY_MS, job->period_ms,
+                      job->jitter_ms, run_network_job, job);
+    return;
+  }
+  job->run();
+}
 
-    // Send heartbeat every 60 seconds (if bound)
-    if (security_manager_is_bound() && wifi_manager_is_connected()) {
-      TickType_t now = xTaskGetTickCount();
-      if ((now - last_heartbeat) >= pdMS_TO_TICKS(60000)) {
-        api_client_send_heartbeat();
-        last_heartbeat = now;
-      }
+static void poll_bind(void *arg) {
+  calx_state_t state = system_state_get();
+
+  // Handle not bound state - request bind code once
+  if (state == STATE_NOT_BOUND && !bind_code_requested &&
+      wifi_manager_is_connected()) {
+    int expires_in;
+    char bind_code[5] = {0};
+    if (api_client_request_bind_code(bind_code, &expires_in)) {
+      ui_manager_show_bind_code(bind_code);
+      system_state_set(STATE_BIND);
+      bind_code_requested = true;
+      LOG_INFO(TAG, "Bind code displayed: %s", bind_code);
     }
+    return; // First status check one interval later
+  }
 
-    // Fetch settings every 5 minutes (if bound)
-    if (security_manager_is_bound() && wifi_manager_is_connected()) {
-      TickType_t now = xTaskGetTickCount();
-      if ((now - last_settings_fetch) >= pdMS_TO_TICKS(300000)) {
-        api_client_fetch_settings();
-        last_settings_fetch = now;
-      }
+  // Poll bind status while in bind state
+  if (state == STATE_BIND) {
+    char token[128];
+    if (api_client_check_bind_status(token)) {
+      // Device is now bound!
+      security_manager_set_token(token);
+      LOG_INFO(TAG, "Device bound successfully!");
+      system_state_set(STATE_IDLE);
+      bind_code_requested = false; // Reset for next time
+      timer_wheel_stop(&bind_timer);
     }
+    return;
+  }
 
-    // Check for OTA updates daily (if bound)
-    if (security_manager_is_bound() && wifi_manager_is_connected()) {
-      TickType_t now = xTaskGetTickCount();
-      if ((now - last_ota_check) >= pdMS_TO_TICKS(86400000)) {
-        update_info_t info;
-        if (api_client_check_update(&info)) {
-          LOG_INFO(TAG, "OTA update available: %s", info.version);
-        }
-        last_ota_check = now;
-      }
-    }
+  // Bound, or offline: nothing to poll until entering STATE_NOT_BOUND or
+  // connecting starts it again
+  if (state != STATE_NOT_BOUND || !wifi_manager_is_connected()) {
+    timer_wheel_stop(&bind_timer);
+  }
+}
+
+// Start polling at once when unbound and there is a connection, or the
+// device has just become unbound
+static void start_bind_polling(calx_event_t *event) {
+  if (!security_manager_is_bound()) {
+    timer_wheel_start(&bind_timer, 0, BIND_POLL_INTERVAL_MS, 0, poll_bind,
+                      NULL);
+  }
+}
+
+static void schedule_network_work(void) {
+  for (size_t i = 0; i < NETWORK_JOB_COUNT; i++) {
+    network_job_t *job = &network_jobs[i];
+    timer_wheel_start(&job->timer, job->period_ms, job->period_ms,
+                      job->jitter_ms, run_network_job, job);
+  }
+  event_manager_register(&wifi_listener, EVENT_WIFI_CONNECTED,
+                         start_bind_polling);
+  event_manager_register(&unbound_listener, EVENT_BIND_REQUIRED,
+                         start_bind_polling);
+}
+
+static void network_task(void *pvParameters) {
+  LOG_INFO(TAG, "Network task started");
 
-    vTaskDelay(pdMS_TO_TICKS(1000));
+  while (1) {
+    // Sleeps until the next scheduled job is due
+    timer_wheel_process();
+    timer_wheel_wait();
   }
 }
 
@@ -247,6 +292,8 @@ void app_main(void) {
   event_manager_init();
   LOG_INFO(TAG, "Event manager initialized");
 
+  timer_wheel_init();
+
   // =========================================================================
   // Phase 5: System State Machine
   // =========================================================================
@@ -271,6 +318,8 @@ void app_main(void) {
 
   LOG_INFO(TAG, "Starting tasks...");
 
+  schedule_network_work();
+
   xTaskCreate(ui_task, "ui_task", TASK_STACK_UI, NULL, TASK_PRIORITY_UI,
               &ui_task_handle);
   xTaskCreate(input_task, "input_task", TASK_STACK_INPUT, NULL,
@@ -313,8 +362,8 @@ void app_main(void) {
 
   // Main task can now idle - other tasks handle the work
   while (1) {
-    // Process events in main loop
+    // Process events in main loop, sleeping until one is posted
     event_manager_process();
-    vTaskDelay(pdMS_TO_TICKS(10));
+    event_manager_wait();
   }
 }
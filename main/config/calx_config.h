@@ -59,14 +59,15 @@
 #define DISPLAY_I2C_SCL_PIN 22
 #define DISPLAY_I2C_FREQ_HZ 400000
 
-// Text rendering (characters per line / lines per screen)
-#define TEXT_SMALL_CHARS_LINE 21 // 4 lines visible
+// Text rendering (lines per screen; lines wrap by pixel width)
 #define TEXT_SMALL_LINES 4
-#define TEXT_NORMAL_CHARS_LINE 16 // 3 lines visible
 #define TEXT_NORMAL_LINES 3
-#define TEXT_LARGE_CHARS_LINE 10 // 2 lines visible
+#define TEXT_MEDIUM_LINES 2
 #define TEXT_LARGE_LINES 2
 
+// UI frame-rate cap: minimum time between frames, 0 for none
+#define UI_MIN_FRAME_MS 16
+
 // =============================================================================
 // Keypad Configuration (Matrix)
 // =============================================================================
@@ -127,6 +128,17 @@ typedef enum { POWER_MODE_NORMAL = 0, POWER_MODE_LOW = 1 } calx_power_mode_t;
 // =============================================================================
 #define HEARTBEAT_NORMAL_INTERVAL_MS 60000    // 60 seconds
 #define HEARTBEAT_LOWPOWER_INTERVAL_MS 600000 // 10 minutes
+#define HEARTBEAT_JITTER_MS 5000
+
+// =============================================================================
+// Scheduled Network Work
+// =============================================================================
+#define BIND_POLL_INTERVAL_MS 5000
+#define SETTINGS_FETCH_INTERVAL_MS 300000 // 5 minutes
+#define SETTINGS_FETCH_JITTER_MS 30000
+#define OTA_CHECK_INTERVAL_MS 86400000 // 24 hours
+#define OTA_CHECK_JITTER_MS 600000     // 10 minutes
+#define NETWORK_RETRY_MS 10000         // While offline or unbound
 
 // =============================================================================
 // OTA Configuration
@@ -154,7 +166,8 @@ typedef enum { POWER_MODE_NORMAL = 0, POWER_MODE_LOW = 1 } calx_power_mode_t;
 typedef enum {
   TEXT_SIZE_SMALL = 0,
   TEXT_SIZE_NORMAL = 1,
-  TEXT_SIZE_LARGE = 2
+  TEXT_SIZE_LARGE = 2,
+  TEXT_SIZE_MEDIUM = 3 // Headings; appended to keep stored values stable
 } calx_text_size_t;
 
 // =============================================================================
@@ -204,7 +217,9 @@ typedef enum {
   EVENT_OTA_FAILED,
   EVENT_TIMEOUT,
   EVENT_API_ERROR,
-  EVENT_API_SUCCESS
+  EVENT_API_SUCCESS,
+  EVENT_BIND_REQUIRED, // Entered STATE_NOT_BOUND
+  EVENT_TYPE_COUNT
 } calx_event_type_t;
 
 // =============================================================================
@@ -3,15 +3,34 @@
  * CalX ESP32 Firmware - Event Manager
  * =============================================================================
  * Decoupled event system for communication between modules.
+ *
+ * Events travel in three priority lanes, drained in order:
+ *  - critical: battery, bind and OTA outcomes
+ *  - input: key presses
+ *  - background: network, chat, file and API notifications
+ *
+ * Key presses and events whose every occurrence matters go through a
+ * FreeRTOS queue per lane. A task posting to a full queue blocks for up to
+ * POST_TIMEOUT_MS; an ISR never blocks. A lock-free ring in place of the
+ * queues was tried and dropped: on the host it was slower once producers
+ * had to retry on a full lane, and it has not been measured on the device.
+ *
+ * Idempotent events ("battery is fine", "scan finished", "new message")
+ * coalesce instead: posting one sets its bit in a pending mask, so repeats
+ * before the consumer runs cost nothing and can never fill a queue. Every
+ * critical event coalesces, so none is ever dropped.
  * =============================================================================
  */
 
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
 #include <string.h>
 
 #include "event_manager.h"
+#include "event_trace.h"
 #include "logger.h"
 #include "system_state.h"
 
@@ -20,37 +39,98 @@ static const char *TAG = "EVENT_MGR";
 // =============================================================================
 // Configuration
 // =============================================================================
-#define EVENT_QUEUE_SIZE 32
-#define MAX_CALLBACKS 8
+#define INPUT_QUEUE_SIZE 32
+#define BACKGROUND_QUEUE_SIZE 16
+#define POST_TIMEOUT_MS 10 // Longest a task waits for room in a full queue
+
+_Static_assert(EVENT_TYPE_COUNT <= 32, "Pending mask holds one bit per type");
 
 // =============================================================================
-// Callback Registration
+// Lanes
 // =============================================================================
+typedef enum { LANE_CRITICAL, LANE_INPUT, LANE_BACKGROUND } event_lane_t;
+
 typedef struct {
-  calx_event_type_t type;
-  event_callback_t callback;
-} event_listener_t;
+  uint8_t lane;       // event_lane_t
+  bool coalesce;      // Pending bit instead of a queue entry; no payload
+  uint8_t supersedes; // Pending event this one cancels, or EVENT_NONE
+} event_route_t;
+
+#define COALESCE(lane_id, cancels) {lane_id, true, cancels}
+
+// Event types not listed go through the background queue
+static const event_route_t routes[EVENT_TYPE_COUNT] = {
+    [EVENT_KEY_PRESS] = {LANE_INPUT, false, EVENT_NONE},
+    [EVENT_KEY_LONG_PRESS] = {LANE_INPUT, false, EVENT_NONE},
+    [EVENT_LOW_BATTERY] = COALESCE(LANE_CRITICAL, EVENT_BATTERY_OK),
+    [EVENT_BATTERY_OK] = COALESCE(LANE_CRITICAL, EVENT_LOW_BATTERY),
+    [EVENT_BIND_SUCCESS] = COALESCE(LANE_CRITICAL, EVENT_BIND_FAILED),
+    [EVENT_BIND_FAILED] = COALESCE(LANE_CRITICAL, EVENT_BIND_SUCCESS),
+    [EVENT_OTA_COMPLETE] = COALESCE(LANE_CRITICAL, EVENT_OTA_FAILED),
+    [EVENT_OTA_FAILED] = COALESCE(LANE_CRITICAL, EVENT_OTA_COMPLETE),
+    [EVENT_WIFI_CONNECTED] =
+        COALESCE(LANE_BACKGROUND, EVENT_WIFI_DISCONNECTED),
+    [EVENT_WIFI_DISCONNECTED] =
+        COALESCE(LANE_BACKGROUND, EVENT_WIFI_CONNECTED),
+    [EVENT_WIFI_SCAN_DONE] = COALESCE(LANE_BACKGROUND, EVENT_NONE),
+    [EVENT_NEW_CHAT_MESSAGE] = COALESCE(LANE_BACKGROUND, EVENT_NONE),
+    [EVENT_AI_RESPONSE_READY] = COALESCE(LANE_BACKGROUND, EVENT_NONE),
+    [EVENT_FILE_UPDATED] = COALESCE(LANE_BACKGROUND, EVENT_NONE),
+    [EVENT_OTA_AVAILABLE] = COALESCE(LANE_BACKGROUND, EVENT_NONE),
+    [EVENT_BIND_REQUIRED] = COALESCE(LANE_BACKGROUND, EVENT_NONE),
+};
+
+#define EVENT_BIT(type) (1u << (type))
 
 // =============================================================================
 // State
 // =============================================================================
-static QueueHandle_t event_queue = NULL;
-static event_listener_t listeners[MAX_CALLBACKS];
-static int listener_count = 0;
+typedef struct {
+  QueueHandle_t queue;
+  _Atomic uint32_t dropped; // Posts lost to a full queue
+  const char *name;
+} event_queue_t;
+
+static event_queue_t input_queue = {.name = "Input"};
+static event_queue_t background_queue = {.name = "Background"};
+
+static _Atomic uint32_t pending;   // Coalesced events, one bit per type
+static uint32_t critical_mask = 0; // Bits of the critical lane
+static bool initialized = false;
+static TaskHandle_t consumer_task = NULL;
+static atomic_bool consumer_sleeping; // Next post must wake consumer_task
+
+// Registered listeners, one list per event type
+static event_listener_t *listeners[EVENT_TYPE_COUNT];
 
 // =============================================================================
 // Initialization
 // =============================================================================
 
+static bool queue_init(event_queue_t *lane, UBaseType_t size) {
+  lane->queue = xQueueCreate(size, sizeof(calx_event_t));
+  atomic_init(&lane->dropped, 0);
+  return lane->queue != NULL;
+}
+
 void event_manager_init(void) {
-  event_queue = xQueueCreate(EVENT_QUEUE_SIZE, sizeof(calx_event_t));
-  if (event_queue == NULL) {
-    LOG_ERROR(TAG, "Failed to create event queue");
+  if (!queue_init(&input_queue, INPUT_QUEUE_SIZE) ||
+      !queue_init(&background_queue, BACKGROUND_QUEUE_SIZE)) {
+    LOG_ERROR(TAG, "Failed to create event queues");
     return;
   }
+  atomic_init(&pending, 0);
+  atomic_init(&consumer_sleeping, false);
+
+  critical_mask = 0;
+  for (int type = 0; type < EVENT_TYPE_COUNT; type++) {
+    if (routes[type].coalesce && routes[type].lane == LANE_CRITICAL) {
+      critical_mask |= EVENT_BIT(type);
+    }
+  }
+  initialized = true;
 
   memset(listeners, 0, sizeof(listeners));
-  listener_count = 0;
 
   LOG_INFO(TAG, "Event manager initialized");
 }
@@ -59,17 +139,72 @@ void event_manager_init(void) {
 // Event Posting
 // =============================================================================
 
+static bool queue_put(event_queue_t *lane, const calx_event_t *event) {
+  BaseType_t sent;
+  if (xPortInIsrContext()) {
+    BaseType_t woken = pdFALSE;
+    sent = xQueueSendFromISR(lane->queue, event, &woken);
+    portYIELD_FROM_ISR(woken);
+  } else {
+    sent = xQueueSend(lane->queue, event, pdMS_TO_TICKS(POST_TIMEOUT_MS));
+  }
+
+  if (sent != pdTRUE) {
+    // Counted rather than logged, as this may run in an ISR
+    atomic_fetch_add_explicit(&lane->dropped, 1, memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+// Mark a coalesced event pending, cancelling the one it supersedes
+static void set_pending(calx_event_type_t type) {
+  uint32_t clear = 0;
+  if (routes[type].supersedes != EVENT_NONE) {
+    clear = EVENT_BIT(routes[type].supersedes);
+  }
+
+  uint32_t old = atomic_load_explicit(&pending, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(
+      &pending, &old, (old & ~clear) | EVENT_BIT(type), memory_order_release,
+      memory_order_relaxed)) {
+  }
+}
+
+static void wake_consumer(void) {
+  // Pairs with the fence in event_manager_wait(): either the consumer sees
+  // this event before sleeping or it is known here to be asleep. Only the
+  // first post after it went to sleep sends the notification.
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&consumer_sleeping, memory_order_relaxed) &&
+      atomic_exchange(&consumer_sleeping, false)) {
+    TaskHandle_t consumer = consumer_task;
+    if (xPortInIsrContext()) {
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(consumer, &woken);
+      portYIELD_FROM_ISR(woken);
+    } else {
+      xTaskNotifyGive(consumer);
+    }
+  }
+}
+
 bool event_manager_post(calx_event_t *event) {
-  if (event_queue == NULL || event == NULL) {
+  if (!initialized || event == NULL || event->type <= EVENT_NONE ||
+      event->type >= EVENT_TYPE_COUNT) {
     return false;
   }
 
-  BaseType_t result = xQueueSend(event_queue, event, pdMS_TO_TICKS(10));
-  if (result != pdTRUE) {
-    LOG_WARN(TAG, "Event queue full, dropping event type %d", event->type);
+  const event_route_t *route = &routes[event->type];
+  if (route->coalesce) {
+    set_pending(event->type);
+  } else if (!queue_put(route->lane == LANE_INPUT ? &input_queue
+                                                  : &background_queue,
+                        event)) {
     return false;
   }
 
+  wake_consumer();
   return true;
 }
 
@@ -88,27 +223,100 @@ bool event_manager_post_key(calx_key_t key, bool long_press) {
 // Event Processing
 // =============================================================================
 
+static bool queue_take(event_queue_t *lane, calx_event_t *event) {
+  return xQueueReceive(lane->queue, event, 0) == pdTRUE;
+}
+
+static bool queue_empty(event_queue_t *lane) {
+  return uxQueueMessagesWaiting(lane->queue) == 0;
+}
+
+// Claim the pending coalesced events among mask
+static uint32_t take_pending(uint32_t mask) {
+  if (!(atomic_load_explicit(&pending, memory_order_relaxed) & mask)) {
+    return 0;
+  }
+  return atomic_fetch_and_explicit(&pending, ~mask, memory_order_acquire) &
+         mask;
+}
+
+static void report_drops(event_queue_t *lane) {
+  uint32_t lost =
+      atomic_exchange_explicit(&lane->dropped, 0, memory_order_relaxed);
+  if (lost) {
+    LOG_WARN(TAG, "%s queue full, dropped %lu events", lane->name,
+             (unsigned long)lost);
+  }
+}
+
+static void dispatch(calx_event_t *event) {
+  event_trace_dispatch_begin(event);
+
+  // Handle key events through state machine
+  if (event->type == EVENT_KEY_PRESS) {
+    system_state_handle_key(event->key, false);
+  } else if (event->type == EVENT_KEY_LONG_PRESS) {
+    system_state_handle_key(event->key, true);
+  }
+
+  // Notify registered listeners; next is read first so a callback may
+  // unregister itself
+  event_listener_t *listener = listeners[event->type];
+  while (listener) {
+    event_listener_t *next = listener->next;
+    listener->callback(event);
+    listener = next;
+  }
+
+  event_trace_dispatch_end();
+}
+
+static void dispatch_pending(uint32_t bits) {
+  while (bits) {
+    int type = __builtin_ctz(bits);
+    bits &= bits - 1;
+    calx_event_t event = {.type = (calx_event_type_t)type, .value = 0};
+    dispatch(&event);
+  }
+}
+
+void event_manager_wait(void) {
+  consumer_task = xTaskGetCurrentTaskHandle();
+  atomic_store(&consumer_sleeping, true);
+  atomic_thread_fence(memory_order_seq_cst);
+
+  // A post after this check leaves a notification pending, so the take
+  // returns at once
+  if (!atomic_load_explicit(&pending, memory_order_relaxed) &&
+      queue_empty(&input_queue) && queue_empty(&background_queue)) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+  atomic_store(&consumer_sleeping, false);
+}
+
 void event_manager_process(void) {
-  if (event_queue == NULL) {
+  if (!initialized) {
     return;
   }
 
-  calx_event_t event;
-
-  // Process all pending events
-  while (xQueueReceive(event_queue, &event, 0) == pdTRUE) {
-    // Handle key events through state machine
-    if (event.type == EVENT_KEY_PRESS) {
-      system_state_handle_key(event.key, false);
-    } else if (event.type == EVENT_KEY_LONG_PRESS) {
-      system_state_handle_key(event.key, true);
-    }
+  report_drops(&input_queue);
+  report_drops(&background_queue);
 
-    // Notify registered listeners
-    for (int i = 0; i < listener_count; i++) {
-      if (listeners[i].type == event.type && listeners[i].callback != NULL) {
-        listeners[i].callback(&event);
-      }
+  // Process all pending events, rechecking the higher lanes after every
+  // event so a critical one posted meanwhile goes next
+  calx_event_t event;
+  for (;;) {
+    uint32_t bits = take_pending(critical_mask);
+    if (bits) {
+      dispatch_pending(bits);
+    } else if (queue_take(&input_queue, &event)) {
+      dispatch(&event);
+    } else if ((bits = take_pending(~critical_mask))) {
+      dispatch_pending(bits);
+    } else if (queue_take(&background_queue, &event)) {
+      dispatch(&event);
+    } else {
+      break;
     }
   }
 }
@@ -117,25 +325,53 @@ void event_manager_process(void) {
 // Callback Registration
 // =============================================================================
 
-void event_manager_register(calx_event_type_t type, event_callback_t callback) {
-  if (listener_count >= MAX_CALLBACKS) {
-    LOG_WARN(TAG, "Max callbacks reached");
+void event_manager_register(event_listener_t *listener, calx_event_type_t type,
+                            event_callback_t callback) {
+  if (listener == NULL || callback == NULL || type <= EVENT_NONE ||
+      type >= EVENT_TYPE_COUNT) {
     return;
   }
 
-  listeners[listener_count].type = type;
-  listeners[listener_count].callback = callback;
-  listener_count++;
+  // Append, keeping registration order
+  event_listener_t **link = &listeners[type];
+  while (*link) {
+    if (*link == listener) {
+      return; // Already registered
+    }
+    link = &(*link)->next;
+  }
+  listener->callback = callback;
+  listener->next = NULL;
+  *link = listener;
 
   LOG_DEBUG(TAG, "Registered callback for event type %d", type);
 }
 
+void event_manager_unregister(event_listener_t *listener,
+                              calx_event_type_t type) {
+  if (listener == NULL || type <= EVENT_NONE || type >= EVENT_TYPE_COUNT) {
+    return;
+  }
+
+  for (event_listener_t **link = &listeners[type]; *link;
+       link = &(*link)->next) {
+    if (*link == listener) {
+      *link = listener->next;
+      return;
+    }
+  }
+}
+
 // =============================================================================
 // Utility
 // =============================================================================
 
 void event_manager_clear(void) {
-  if (event_queue != NULL) {
-    xQueueReset(event_queue);
+  if (!initialized) {
+    return;
   }
+
+  xQueueReset(input_queue.queue);
+  xQueueReset(background_queue.queue);
+  atomic_store_explicit(&pending, 0, memory_order_relaxed);
 }
@@ -27,15 +27,31 @@ typedef struct {
  */
 typedef void (*event_callback_t)(calx_event_t *event);
 
+typedef struct event_listener event_listener_t;
+
+/**
+ * A registered callback, owned by the caller and linked in place
+ */
+struct event_listener {
+  event_callback_t callback;
+  event_listener_t *next; // Listeners of the same type
+};
+
 /**
  * Initialize the event manager
  */
 void event_manager_init(void);
 
 /**
- * Post an event to the queue
+ * Post an event to its priority lane
+ * Safe from any task or ISR. A task waits up to 10 ms for room in a full
+ * lane; an ISR never waits. Critical and idempotent events (battery, bind,
+ * OTA, WiFi, chat and file notifications) coalesce with a pending one of
+ * the same type and are delivered without a payload;
+ * LOW_BATTERY/BATTERY_OK, BIND_SUCCESS/BIND_FAILED, OTA_COMPLETE/OTA_FAILED
+ * and WIFI_CONNECTED/WIFI_DISCONNECTED each cancel a pending opposite.
  * @param event Event to post
- * @return true if successful
+ * @return true if successful, false if its lane is full
  */
 bool event_manager_post(calx_event_t *event);
 
@@ -54,20 +70,41 @@ bool event_manager_post_simple(calx_event_type_t type);
  */
 bool event_manager_post_key(calx_key_t key, bool long_press);
 
+/**
+ * Block the calling task until an event has been posted
+ * The caller becomes the consumer that posts wake.
+ */
+void event_manager_wait(void);
+
 /**
  * Process pending events (called from main loop)
+ * Critical events go first, then key presses, then background events.
+ * Only call from the consumer task.
  */
 void event_manager_process(void);
 
 /**
  * Register a callback for a specific event type
+ * The listener is linked into the type's list, so there is no limit and
+ * nothing is allocated; it must stay valid (usually static) while
+ * registered. Listeners of a type run in registration order. Call during
+ * init or from the consumer task.
+ * @param listener Listener to link; registering it twice does nothing
  * @param type Event type to listen for
  * @param callback Function to call when event occurs
  */
-void event_manager_register(calx_event_type_t type, event_callback_t callback);
+void event_manager_register(event_listener_t *listener, calx_event_type_t type,
+                            event_callback_t callback);
+
+/**
+ * Unlink a listener registered for a type
+ * A callback may unregister itself while it runs.
+ */
+void event_manager_unregister(event_listener_t *listener,
+                              calx_event_type_t type);
 
 /**
- * Clear all pending events
+ * Clear all pending events (from the consumer task)
  */
 void event_manager_clear(void);
 
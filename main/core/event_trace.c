@@ -0,0 +1,81 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Event Trace
+ * =============================================================================
+ * Writers claim a record with one atomic add and fill it in place, without
+ * a lock. A record being overwritten while it is read may come out torn,
+ * which a dump taken in the field can live with.
+ * =============================================================================
+ */
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+
+#include "event_trace.h"
+
+// =============================================================================
+// State
+// =============================================================================
+#define TRACE_MASK (EVENT_TRACE_RECORDS - 1)
+
+_Static_assert(sizeof(trace_record_t) == 8, "Trace records are 8 bytes");
+
+static trace_record_t records[EVENT_TRACE_RECORDS];
+static _Atomic uint32_t head; // Sequence number of the next record
+
+// Event being dispatched, for attributing transitions
+static TaskHandle_t dispatch_task = NULL;
+static uint8_t dispatch_type = EVENT_NONE;
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+static void put(uint8_t type, uint8_t arg, uint8_t from, uint8_t to) {
+  uint32_t seq = atomic_fetch_add_explicit(&head, 1, memory_order_relaxed);
+  trace_record_t *record = &records[seq & TRACE_MASK];
+  record->time_us = (uint32_t)esp_timer_get_time();
+  record->type = type;
+  record->arg = arg;
+  record->from = from;
+  record->to = to;
+}
+
+void event_trace_dispatch_begin(const calx_event_t *event) {
+  dispatch_task = xTaskGetCurrentTaskHandle();
+  dispatch_type = event->type;
+
+  bool is_key =
+      event->type == EVENT_KEY_PRESS || event->type == EVENT_KEY_LONG_PRESS;
+  put(event->type, is_key ? event->key : 0, 0, 0);
+}
+
+void event_trace_dispatch_end(void) { dispatch_type = EVENT_NONE; }
+
+void event_trace_state(calx_state_t from, calx_state_t to) {
+  uint8_t cause = EVENT_NONE;
+  if (dispatch_type != EVENT_NONE &&
+      dispatch_task == xTaskGetCurrentTaskHandle()) {
+    cause = dispatch_type;
+  }
+  put(EVENT_NONE, cause, from, to);
+}
+
+// =============================================================================
+// Reading
+// =============================================================================
+
+uint32_t event_trace_count(void) {
+  return atomic_load_explicit(&head, memory_order_relaxed);
+}
+
+bool event_trace_get(uint32_t seq, trace_record_t *record) {
+  uint32_t end = event_trace_count();
+  if (end - seq - 1 >= EVENT_TRACE_RECORDS) {
+    return false; // Not written yet, or lapped
+  }
+  *record = records[seq & TRACE_MASK];
+  return true;
+}
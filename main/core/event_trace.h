@@ -0,0 +1,81 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Event Trace Header
+ * =============================================================================
+ * Flight recorder for field debugging: every dispatched event and every
+ * state transition is written as an 8-byte record into a fixed RAM ring.
+ * The ring is served at /trace.bin and can be replayed against the host
+ * build in test/host to reproduce the same key and event sequence.
+ * =============================================================================
+ */
+
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include "calx_config.h"
+#include "event_manager.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define EVENT_TRACE_RECORDS 512 // Power of two, 4 KB
+#define EVENT_TRACE_MAGIC "CXTR"
+#define EVENT_TRACE_VERSION 1
+
+/**
+ * One trace record
+ * A dispatched event has its type, and its key for key events. A state
+ * transition has type EVENT_NONE, the states it went from and to and, if
+ * an event handler made it, that event's type.
+ */
+typedef struct {
+  uint32_t time_us; // Low 32 bits of esp_timer_get_time()
+  uint8_t type;     // calx_event_type_t
+  uint8_t arg;      // Event: calx_key_t; transition: cause or EVENT_NONE
+  uint8_t from;     // calx_state_t, transitions only
+  uint8_t to;       // calx_state_t, transitions only
+} trace_record_t;
+
+/**
+ * Header of a trace dump, followed by count records oldest first
+ * All fields are little-endian.
+ */
+typedef struct {
+  char magic[4];       // EVENT_TRACE_MAGIC
+  uint8_t version;     // EVENT_TRACE_VERSION
+  uint8_t record_size; // sizeof(trace_record_t)
+  uint16_t reserved;
+  uint32_t first; // Sequence number of the first record
+  uint32_t count;
+} trace_header_t;
+
+/**
+ * Record an event as its dispatch begins
+ * Called by the event manager; transitions made on the same task until
+ * event_trace_dispatch_end() are attributed to it.
+ */
+void event_trace_dispatch_begin(const calx_event_t *event);
+
+/**
+ * Mark the end of the dispatch started by event_trace_dispatch_begin()
+ */
+void event_trace_dispatch_end(void);
+
+/**
+ * Record a state transition
+ * Called by the state machine; safe from any task.
+ */
+void event_trace_state(calx_state_t from, calx_state_t to);
+
+/**
+ * Get the number of records written since boot
+ * The ring holds the last EVENT_TRACE_RECORDS of them.
+ */
+uint32_t event_trace_count(void);
+
+/**
+ * Read one record by sequence number
+ * @return false if it has not been written or was overwritten
+ */
+bool event_trace_get(uint32_t seq, trace_record_t *record);
+
+#endif // EVENT_TRACE_H
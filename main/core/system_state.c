@@ -12,9 +12,12 @@
 #include <string.h>
 
 #include "api_client.h"
+#include "chat_history.h"
 #include "event_manager.h"
+#include "event_trace.h"
 #include "logger.h"
 #include "system_state.h"
+#include "timer_wheel.h"
 #include "ui_manager.h"
 #include "wifi_manager.h"
 
@@ -34,11 +37,14 @@ static int settings_selection = 0;
 
 // Busy state tracking
 static bool is_busy = false;
-static TickType_t last_heartbeat = 0;
+
+// Fetch for the screen just entered, run by the network task
+static wheel_timer_t entry_fetch_timer;
 
 // Forward declarations
 static void handle_menu_key(calx_key_t key);
 static void select_menu_item(int item);
+static void fetch_on_entry(void *arg);
 
 // =============================================================================
 // State Transition Table
@@ -56,11 +62,22 @@ void system_state_set(calx_state_t state) {
   if (xSemaphoreTake(state_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
     if (state != current_state) {
       LOG_INFO(TAG, "State: %d -> %d", current_state, state);
+      event_trace_state(current_state, state);
       previous_state = current_state;
       current_state = state;
 
       // Notify UI of state change
       ui_manager_on_state_change(state);
+
+      // Bind polling only runs while it is needed
+      if (state == STATE_NOT_BOUND) {
+        event_manager_post_simple(EVENT_BIND_REQUIRED);
+      }
+
+      // Screens showing server data fetch it when opened
+      if (state == STATE_CHAT || state == STATE_FILE) {
+        timer_wheel_start(&entry_fetch_timer, 0, 0, 0, fetch_on_entry, NULL);
+      }
     }
     xSemaphoreGive(state_mutex);
   }
@@ -128,8 +145,10 @@ void system_state_handle_key(calx_key_t key, bool long_press) {
       system_state_go_idle();
       return;
     } else {
-      // AC short press goes back
-      system_state_go_back();
+      // AC short press closes a view inside the screen, else goes back
+      if (!ui_manager_handle_back()) {
+        system_state_go_back();
+      }
       return;
     }
   }
@@ -251,64 +270,47 @@ static void select_menu_item(int item) {
 // Network Processing
 // =============================================================================
 
-void system_state_process_network(void) {
+// Fetch what the screen just opened shows, on the network task
+static void fetch_on_entry(void *arg) {
   calx_state_t state = system_state_get();
-  TickType_t now = xTaskGetTickCount();
 
-  // Don't process network if WiFi not connected
   if (!wifi_manager_is_connected()) {
+    // Try again soon while the screen is still open
+    if (state == STATE_CHAT || state == STATE_FILE) {
+      timer_wheel_start(&entry_fetch_timer, NETWORK_RETRY_MS, 0, 0,
+                        fetch_on_entry, NULL);
+    }
     return;
   }
 
-  // Heartbeat (in any connected state)
-  if (state == STATE_IDLE || state == STATE_MENU || state == STATE_CHAT ||
-      state == STATE_FILE || state == STATE_AI) {
-
-    TickType_t heartbeat_interval = pdMS_TO_TICKS(HEARTBEAT_NORMAL_INTERVAL_MS);
-
-    if ((now - last_heartbeat) >= heartbeat_interval) {
-      is_busy = true;
-      api_client_send_heartbeat();
-      last_heartbeat = now;
-      is_busy = false;
+  is_busy = true;
+  switch (state) {
+  case STATE_CHAT: {
+    // Fetch messages newer than the cached ones into the chat history
+    char since[CHAT_TIMESTAMP_MAX];
+    bool cached = chat_history_latest_timestamp(since, sizeof(since));
+    int count = api_client_fetch_chat(ui_manager_add_chat_message,
+                                      CHAT_HISTORY_MAX_MESSAGES,
+                                      cached ? since : NULL);
+    LOG_INFO(TAG, "Fetched %d chat messages", count);
+  } break;
+
+  case STATE_FILE: {
+    // The file viewer draws straight from the buffer it was given, so the
+    // fetch fills the other one and the viewer switches over when it is
+    // complete; the previous file stays up meanwhile
+    static file_content_t files[2];
+    static int shown = -1;
+    int next = (shown == 0) ? 1 : 0;
+    if (api_client_fetch_file(&files[next])) {
+      ui_manager_set_file_content(files[next].content);
+      shown = next;
+      LOG_INFO(TAG, "File fetched: %d chars", files[next].char_count);
     }
-  }
-
-  // State-specific network operations on entry
-  static calx_state_t last_processed_state = STATE_BOOT;
-
-  if (state != last_processed_state) {
-    // State just entered - fetch data
-    switch (state) {
-    case STATE_CHAT: {
-      // Fetch chat messages
-      chat_message_t messages[10];
-      int count = api_client_fetch_chat(messages, 10, NULL);
-      if (count > 0) {
-        // Display first message (simplified)
-        ui_manager_set_file_content(messages[0].content);
-      }
-      LOG_INFO(TAG, "Fetched %d chat messages", count);
-    } break;
-
-    case STATE_FILE: {
-      // Fetch file content
-      file_content_t file;
-      if (api_client_fetch_file(&file)) {
-        ui_manager_set_file_content(file.content);
-        LOG_INFO(TAG, "File fetched: %d chars", file.char_count);
-      }
-    } break;
-
-    case STATE_AI: {
-      // AI query would be triggered by calculator input
-      // For now, just log that we're ready
-      LOG_INFO(TAG, "AI mode ready for queries");
-    } break;
+  } break;
 
-    default:
-      break;
-    }
-    last_processed_state = state;
+  default:
+    break; // Left before the fetch ran
   }
+  is_busy = false;
 }
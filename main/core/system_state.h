@@ -42,12 +42,6 @@ void system_state_go_back(void);
  */
 void system_state_go_idle(void);
 
-/**
- * Process network operations based on current state
- * Called from network task
- */
-void system_state_process_network(void);
-
 /**
  * Handle key press in current state
  * @param key The key that was pressed
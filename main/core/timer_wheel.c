@@ -0,0 +1,312 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Timer Wheel
+ * =============================================================================
+ * Hierarchical timer wheel: four levels of 64 slots, each slot of a level
+ * spanning a whole lap of the level below. A timer goes into the coarsest
+ * level that still tells it apart from now and cascades down a level each
+ * time the wheel reaches its slot, so scheduling and cancelling are O(1).
+ * The levels cover 2^24 ticks; later deadlines wait in the top level and
+ * are re-sorted whenever it comes round.
+ *
+ * An occupancy bitmap per level lets the wheel jump straight to the next
+ * occupied slot, so a long sleep is caught up in a few steps rather than
+ * one per tick.
+ * =============================================================================
+ */
+
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "logger.h"
+#include "timer_wheel.h"
+
+static const char *TAG = "TIMER";
+
+// =============================================================================
+// Configuration
+// =============================================================================
+#define WHEEL_LEVELS 4
+#define WHEEL_BITS 6 // 64 slots per level
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_RANGE ((TickType_t)1 << (WHEEL_LEVELS * WHEEL_BITS))
+
+// =============================================================================
+// State
+// =============================================================================
+static SemaphoreHandle_t wheel_mutex = NULL;
+static wheel_timer_t *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t occupied[WHEEL_LEVELS]; // Bit per non-empty slot
+static TickType_t wheel_time = 0;       // Tick whose level 0 slot is due
+static TaskHandle_t owner_task = NULL;
+static bool owner_sleeping = false; // Scheduling must wake owner_task
+
+// =============================================================================
+// Slots
+// =============================================================================
+
+static void link_timer(wheel_timer_t *timer) {
+  TickType_t delta = timer->expiry - wheel_time;
+  if ((int32_t)delta < 0) {
+    delta = 0; // Overdue: runs on the next pass
+  } else if (delta >= WHEEL_RANGE) {
+    delta = WHEEL_RANGE - 1; // Re-sorted when the top level comes round
+  }
+  TickType_t when = wheel_time + delta;
+
+  int level = 0;
+  while (level < WHEEL_LEVELS - 1 &&
+         delta >= (TickType_t)1 << (WHEEL_BITS * (level + 1))) {
+    level++;
+  }
+  int slot = (when >> (WHEEL_BITS * level)) & WHEEL_MASK;
+
+  wheel_timer_t **head = &slots[level][slot];
+  timer->next = *head;
+  if (timer->next) {
+    timer->next->link = &timer->next;
+  }
+  *head = timer;
+  timer->link = head;
+  timer->level = level;
+  timer->slot = slot;
+  occupied[level] |= (uint64_t)1 << slot;
+}
+
+static void unlink_timer(wheel_timer_t *timer) {
+  *timer->link = timer->next;
+  if (timer->next) {
+    timer->next->link = timer->link;
+  }
+  if (!slots[timer->level][timer->slot]) {
+    occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+  }
+  timer->link = NULL;
+}
+
+// Move every timer of a slot down to the level that now fits it
+static void cascade(int level, int slot) {
+  wheel_timer_t *timer = slots[level][slot];
+  slots[level][slot] = NULL;
+  occupied[level] &= ~((uint64_t)1 << slot);
+
+  while (timer) {
+    wheel_timer_t *next = timer->next;
+    link_timer(timer);
+    timer = next;
+  }
+}
+
+// Move the wheel to tick t, cascading the slots that start there
+static void advance_to(TickType_t t) {
+  wheel_time = t;
+  for (int level = 1; level < WHEEL_LEVELS; level++) {
+    int shift = WHEEL_BITS * level;
+    if (t & (((TickType_t)1 << shift) - 1)) {
+      break;
+    }
+    cascade(level, (t >> shift) & WHEEL_MASK);
+  }
+}
+
+// Distance from slot cur to the next occupied slot after it, 1 to 64
+// (cur itself, one lap on), or 0 if the level is empty
+static int next_occupied(uint64_t bits, int cur) {
+  if (!bits) {
+    return 0;
+  }
+  int from = (cur + 1) & WHEEL_MASK;
+  uint64_t rotated = (bits >> from) | (from ? bits << (WHEEL_SLOTS - from) : 0);
+  return 1 + __builtin_ctzll(rotated);
+}
+
+/**
+ * Find the next tick the wheel must stop at
+ * With exact set, this is the earliest expiry of any timer; otherwise it
+ * may be an earlier cascade, which the wheel must not step over.
+ * @return false if no timer is scheduled
+ */
+static bool next_stop(bool exact, TickType_t *delta) {
+  if (slots[0][wheel_time & WHEEL_MASK]) {
+    *delta = 0;
+    return true;
+  }
+
+  bool any = false;
+  for (int level = 0; level < WHEEL_LEVELS; level++) {
+    int shift = WHEEL_BITS * level;
+    int distance =
+        next_occupied(occupied[level], (wheel_time >> shift) & WHEEL_MASK);
+    if (!distance) {
+      continue;
+    }
+
+    TickType_t when = ((wheel_time >> shift) + distance) << shift;
+    if (exact && level > 0) {
+      // A slot holds one span of expiries, earlier than any later slot's
+      wheel_timer_t *timer = slots[level][(when >> shift) & WHEEL_MASK];
+      when = timer->expiry;
+      for (timer = timer->next; timer; timer = timer->next) {
+        if ((int32_t)(timer->expiry - when) < 0) {
+          when = timer->expiry;
+        }
+      }
+    }
+
+    TickType_t d = when - wheel_time;
+    if ((int32_t)d < 0) {
+      d = 0;
+    }
+    if (!any || d < *delta) {
+      *delta = d;
+      any = true;
+    }
+  }
+  return any;
+}
+
+// Unlink the next timer due by now, moving the wheel up to it
+static wheel_timer_t *take_due(TickType_t now) {
+  for (;;) {
+    wheel_timer_t *timer = slots[0][wheel_time & WHEEL_MASK];
+    if (timer) {
+      unlink_timer(timer);
+      return timer;
+    }
+    if (wheel_time == now) {
+      return NULL;
+    }
+
+    TickType_t delta;
+    TickType_t behind = now - wheel_time;
+    if (next_stop(false, &delta) && delta <= behind) {
+      advance_to(wheel_time + delta);
+    } else {
+      advance_to(now); // Nothing in between
+    }
+  }
+}
+
+static TickType_t random_jitter(TickType_t jitter) {
+  return jitter ? esp_random() % (jitter + 1) : 0;
+}
+
+// =============================================================================
+// Initialization
+// =============================================================================
+
+void timer_wheel_init(void) {
+  wheel_mutex = xSemaphoreCreateMutex();
+  wheel_time = xTaskGetTickCount();
+  LOG_INFO(TAG, "Timer wheel initialized");
+}
+
+// =============================================================================
+// Scheduling
+// =============================================================================
+
+void timer_wheel_start(wheel_timer_t *timer, uint32_t delay_ms,
+                       uint32_t period_ms, uint32_t jitter_ms,
+                       wheel_callback_t callback, void *arg) {
+  if (!wheel_mutex || !timer || !callback) {
+    return;
+  }
+
+  xSemaphoreTake(wheel_mutex, portMAX_DELAY);
+  if (timer->link) {
+    unlink_timer(timer);
+  }
+  timer->expiry = xTaskGetTickCount() + pdMS_TO_TICKS(delay_ms);
+  timer->period = pdMS_TO_TICKS(period_ms);
+  timer->jitter = pdMS_TO_TICKS(jitter_ms);
+  timer->callback = callback;
+  timer->arg = arg;
+  link_timer(timer);
+
+  // The owner recomputes its deadline when woken
+  TaskHandle_t wake = NULL;
+  if (owner_sleeping && owner_task != xTaskGetCurrentTaskHandle()) {
+    owner_sleeping = false;
+    wake = owner_task;
+  }
+  xSemaphoreGive(wheel_mutex);
+
+  if (wake) {
+    xTaskNotifyGive(wake);
+  }
+}
+
+void timer_wheel_stop(wheel_timer_t *timer) {
+  if (!wheel_mutex || !timer) {
+    return;
+  }
+
+  xSemaphoreTake(wheel_mutex, portMAX_DELAY);
+  if (timer->link) {
+    unlink_timer(timer);
+  }
+  xSemaphoreGive(wheel_mutex);
+}
+
+// =============================================================================
+// Owning Task
+// =============================================================================
+
+void timer_wheel_process(void) {
+  if (!wheel_mutex) {
+    return;
+  }
+
+  for (;;) {
+    xSemaphoreTake(wheel_mutex, portMAX_DELAY);
+    TickType_t now = xTaskGetTickCount();
+    wheel_timer_t *timer = take_due(now);
+    if (!timer) {
+      xSemaphoreGive(wheel_mutex);
+      return;
+    }
+
+    // Re-arm from now rather than from the missed deadline, so a late run
+    // does not cause a burst of catch-up runs
+    wheel_callback_t callback = timer->callback;
+    void *arg = timer->arg;
+    if (timer->period) {
+      timer->expiry = now + timer->period + random_jitter(timer->jitter);
+      link_timer(timer);
+    }
+    xSemaphoreGive(wheel_mutex);
+
+    callback(arg);
+  }
+}
+
+void timer_wheel_wait(void) {
+  if (!wheel_mutex) {
+    return;
+  }
+
+  xSemaphoreTake(wheel_mutex, portMAX_DELAY);
+  owner_task = xTaskGetCurrentTaskHandle();
+
+  TickType_t timeout = portMAX_DELAY;
+  TickType_t delta;
+  if (next_stop(true, &delta)) {
+    TickType_t left = wheel_time + delta - xTaskGetTickCount();
+    timeout = ((int32_t)left > 0) ? left : 0;
+  }
+  owner_sleeping = timeout > 0;
+  xSemaphoreGive(wheel_mutex);
+
+  // A start() after the unlock leaves a notification pending, so the take
+  // returns at once
+  if (timeout > 0) {
+    ulTaskNotifyTake(pdTRUE, timeout);
+  }
+
+  xSemaphoreTake(wheel_mutex, portMAX_DELAY);
+  owner_sleeping = false;
+  xSemaphoreGive(wheel_mutex);
+}
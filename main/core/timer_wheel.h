@@ -0,0 +1,74 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Timer Wheel Header
+ * =============================================================================
+ * One-shot and periodic callbacks run by a single owning task, which sleeps
+ * until the next deadline instead of polling. Timers are owned by the
+ * caller and linked in place, so scheduling never allocates.
+ * =============================================================================
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef void (*wheel_callback_t)(void *arg);
+
+typedef struct wheel_timer wheel_timer_t;
+
+/**
+ * A scheduled callback
+ * Fields are managed by the timer wheel; zero-initialize and leave alone.
+ */
+struct wheel_timer {
+  TickType_t expiry;
+  TickType_t period; // 0 for one-shot
+  TickType_t jitter; // Random extra delay, up to this, per period
+  wheel_callback_t callback;
+  void *arg;
+  wheel_timer_t *next;
+  wheel_timer_t **link; // Pointer to this, NULL when not scheduled
+  uint8_t level, slot;
+};
+
+/**
+ * Initialize the timer wheel
+ */
+void timer_wheel_init(void);
+
+/**
+ * Schedule (or reschedule) a timer
+ * Safe from any task, including from its own callback.
+ * @param timer Timer to schedule; must stay valid while scheduled
+ * @param delay_ms Time until the first run
+ * @param period_ms Time between runs after that, 0 to run once
+ * @param jitter_ms Random extra delay of up to this before every run after
+ *                  the first, so devices spread their network requests
+ * @param callback Function to run in the owning task
+ * @param arg Passed to the callback
+ */
+void timer_wheel_start(wheel_timer_t *timer, uint32_t delay_ms,
+                       uint32_t period_ms, uint32_t jitter_ms,
+                       wheel_callback_t callback, void *arg);
+
+/**
+ * Cancel a timer; does nothing if it is not scheduled
+ */
+void timer_wheel_stop(wheel_timer_t *timer);
+
+/**
+ * Run the callbacks of every timer that is due
+ * Only call from the owning task.
+ */
+void timer_wheel_process(void);
+
+/**
+ * Block the calling task until the next timer is due or one is scheduled
+ * The caller becomes the owning task that scheduling wakes.
+ */
+void timer_wheel_wait(void);
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,67 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - UTF-8 Decoding
+ * =============================================================================
+ * Text from the backend is UTF-8. The decoder is inline because it runs for
+ * every character drawn or measured.
+ * =============================================================================
+ */
+
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdint.h>
+
+#define UTF8_REPLACEMENT 0xFFFD
+
+/**
+ * Decode the code point at *s and advance *s past it
+ * Malformed, overlong or truncated sequences decode as UTF8_REPLACEMENT and
+ * consume a single byte, so decoding always makes progress. Never reads past
+ * a terminating NUL.
+ * @param s Pointer into a NUL-terminated string (not at the terminator)
+ * @return Decoded code point
+ */
+static inline uint32_t utf8_next(const char **s) {
+  const uint8_t *p = (const uint8_t *)*s;
+  uint32_t code;
+  int extra;
+
+  if (p[0] < 0x80) {
+    *s += 1;
+    return p[0];
+  } else if ((p[0] & 0xE0) == 0xC0) {
+    code = p[0] & 0x1F;
+    extra = 1;
+  } else if ((p[0] & 0xF0) == 0xE0) {
+    code = p[0] & 0x0F;
+    extra = 2;
+  } else if ((p[0] & 0xF8) == 0xF0) {
+    code = p[0] & 0x07;
+    extra = 3;
+  } else {
+    *s += 1;
+    return UTF8_REPLACEMENT;
+  }
+
+  for (int i = 1; i <= extra; i++) {
+    if ((p[i] & 0xC0) != 0x80) {
+      *s += 1;
+      return UTF8_REPLACEMENT;
+    }
+    code = (code << 6) | (p[i] & 0x3F);
+  }
+
+  // Reject overlong forms, surrogates and values past U+10FFFF
+  static const uint32_t min_code[] = {0, 0x80, 0x800, 0x10000};
+  if (code < min_code[extra] || (code >= 0xD800 && code <= 0xDFFF) ||
+      code > 0x10FFFF) {
+    *s += 1;
+    return UTF8_REPLACEMENT;
+  }
+
+  *s += extra + 1;
+  return code;
+}
+
+#endif // UTF8_H
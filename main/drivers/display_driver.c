@@ -3,15 +3,26 @@
  * CalX ESP32 Firmware - Display Driver
  * =============================================================================
  * SSD1306 OLED driver for 128x32 display via I2C.
+ * Frames are handed off to a flush task so rendering of the next frame
+ * overlaps the bus transfer of the current one. Vertical scrolling moves the
+ * display start line over the panel's 64-row GDDRAM instead of rewriting
+ * the rows that are already on the glass.
  * =============================================================================
  */
 
 #include "driver/i2c.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
 #include <string.h>
 
 #include "display_driver.h"
+#include "font.h"
 #include "logger.h"
+#include "utf8.h"
 
 static const char *TAG = "DISPLAY";
 
@@ -21,10 +32,15 @@ static const char *TAG = "DISPLAY";
 #define I2C_MASTER_NUM I2C_NUM_0
 #define I2C_TIMEOUT_MS 1000
 
+// Flush task
+#define FLUSH_TASK_STACK 2048
+#define FLUSH_TASK_PRIORITY 5
+
 // =============================================================================
 // SSD1306 Commands
 // =============================================================================
-#define SSD1306_CMD 0x00
+#define SSD1306_CMD 0x00        // Co=0: rest of transaction is commands
+#define SSD1306_CMD_SINGLE 0x80 // Co=1: one command, then another control byte
 #define SSD1306_DATA 0x40
 
 #define SSD1306_SETCONTRAST 0x81
@@ -55,139 +71,203 @@ static const char *TAG = "DISPLAY";
 // Display Buffer
 // =============================================================================
 #define BUFFER_SIZE (DISPLAY_WIDTH * DISPLAY_HEIGHT / 8)
-static uint8_t display_buffer[BUFFER_SIZE];
+#define DISPLAY_PAGES (DISPLAY_HEIGHT / 8)
+#define GDDRAM_PAGES 8 // Controller RAM is 64 rows, only 32 are shown
+#define GDDRAM_ROWS (GDDRAM_PAGES * 8)
+#define SCREEN_ROWS (((uint64_t)1 << DISPLAY_HEIGHT) - 1)
+
+// Scrolling treats a column of the frame as one word, bit y for row y
+_Static_assert(DISPLAY_HEIGHT <= 32, "A frame column must fit a word");
+
+// Three frame buffers: the one being drawn, the last complete frame, and the
+// one held by the reader (the web display). display_driver_update() swaps the
+// drawn frame into the ready slot with a single atomic exchange, so readers
+// never see a half-drawn frame and neither side ever waits for the other.
+// Stored as words so the rectangle kernels can touch four columns at once;
+// everything else addresses the draw buffer bytewise through display_buffer.
+#define FRAME_INDEX_MASK 0x3
+#define FRAME_FRESH 0x4 // Ready slot holds a frame the reader hasn't taken
+static uint32_t frame_words[3][BUFFER_SIZE / 4];
+static _Atomic uint32_t ready_slot = 1;
+static int read_index = 2; // Only touched by the reader
+
+static uint32_t *display_words = frame_words[0];
+static uint8_t *display_buffer = (uint8_t *)frame_words[0];
+static int draw_index = 0;
+
+// Shadow of the panel's GDDRAM as of the last flush. Diffing against it lets
+// an update send only the changed column span of each changed page, even
+// though screens are cleared and redrawn from scratch every frame.
+static uint8_t panel_buffer[GDDRAM_PAGES * DISPLAY_WIDTH];
+static uint8_t panel_valid_pages = 0; // Bit per GDDRAM page the shadow knows
+
+// GDDRAM is used as a ring of rows: row y of the frame buffer lives in GDDRAM
+// row (scroll_base + y) % GDDRAM_ROWS and the start line points at
+// scroll_base. Scrolling rotates the ring, so rows that stay on screen are
+// already in place and only the exposed rows differ from the shadow. When
+// scroll_base is not a multiple of 8 the frame straddles one more GDDRAM page
+// than it has pages.
+static int scroll_base = 0;
+static int panel_start_line = 0; // Start line as last sent to the panel
+
+static display_stats_t stats = {0};
+static bool updates_held = false;
 
 // =============================================================================
-// Font Data (6x8 basic font)
+// Flush State
 // =============================================================================
-// Basic 6x8 ASCII font (characters 32-127)
-static const uint8_t font_6x8[] = {
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Space
-    0x00, 0x00, 0x5F, 0x00, 0x00, 0x00, // !
-    0x00, 0x07, 0x00, 0x07, 0x00, 0x00, // "
-    0x14, 0x7F, 0x14, 0x7F, 0x14, 0x00, // #
-    0x24, 0x2A, 0x7F, 0x2A, 0x12, 0x00, // $
-    0x23, 0x13, 0x08, 0x64, 0x62, 0x00, // %
-    0x36, 0x49, 0x56, 0x20, 0x50, 0x00, // &
-    0x00, 0x08, 0x07, 0x03, 0x00, 0x00, // '
-    0x00, 0x1C, 0x22, 0x41, 0x00, 0x00, // (
-    0x00, 0x41, 0x22, 0x1C, 0x00, 0x00, // )
-    0x2A, 0x1C, 0x7F, 0x1C, 0x2A, 0x00, // *
-    0x08, 0x08, 0x3E, 0x08, 0x08, 0x00, // +
-    0x00, 0x80, 0x70, 0x30, 0x00, 0x00, // ,
-    0x08, 0x08, 0x08, 0x08, 0x08, 0x00, // -
-    0x00, 0x00, 0x60, 0x60, 0x00, 0x00, // .
-    0x20, 0x10, 0x08, 0x04, 0x02, 0x00, // /
-    0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00, // 0
-    0x00, 0x42, 0x7F, 0x40, 0x00, 0x00, // 1
-    0x72, 0x49, 0x49, 0x49, 0x46, 0x00, // 2
-    0x21, 0x41, 0x49, 0x4D, 0x33, 0x00, // 3
-    0x18, 0x14, 0x12, 0x7F, 0x10, 0x00, // 4
-    0x27, 0x45, 0x45, 0x45, 0x39, 0x00, // 5
-    0x3C, 0x4A, 0x49, 0x49, 0x31, 0x00, // 6
-    0x41, 0x21, 0x11, 0x09, 0x07, 0x00, // 7
-    0x36, 0x49, 0x49, 0x49, 0x36, 0x00, // 8
-    0x46, 0x49, 0x49, 0x29, 0x1E, 0x00, // 9
-    0x00, 0x00, 0x14, 0x00, 0x00, 0x00, // :
-    0x00, 0x40, 0x34, 0x00, 0x00, 0x00, // ;
-    0x00, 0x08, 0x14, 0x22, 0x41, 0x00, // <
-    0x14, 0x14, 0x14, 0x14, 0x14, 0x00, // =
-    0x00, 0x41, 0x22, 0x14, 0x08, 0x00, // >
-    0x02, 0x01, 0x59, 0x09, 0x06, 0x00, // ?
-    0x3E, 0x41, 0x5D, 0x59, 0x4E, 0x00, // @
-    0x7C, 0x12, 0x11, 0x12, 0x7C, 0x00, // A
-    0x7F, 0x49, 0x49, 0x49, 0x36, 0x00, // B
-    0x3E, 0x41, 0x41, 0x41, 0x22, 0x00, // C
-    0x7F, 0x41, 0x41, 0x41, 0x3E, 0x00, // D
-    0x7F, 0x49, 0x49, 0x49, 0x41, 0x00, // E
-    0x7F, 0x09, 0x09, 0x09, 0x01, 0x00, // F
-    0x3E, 0x41, 0x41, 0x51, 0x73, 0x00, // G
-    0x7F, 0x08, 0x08, 0x08, 0x7F, 0x00, // H
-    0x00, 0x41, 0x7F, 0x41, 0x00, 0x00, // I
-    0x20, 0x40, 0x41, 0x3F, 0x01, 0x00, // J
-    0x7F, 0x08, 0x14, 0x22, 0x41, 0x00, // K
-    0x7F, 0x40, 0x40, 0x40, 0x40, 0x00, // L
-    0x7F, 0x02, 0x1C, 0x02, 0x7F, 0x00, // M
-    0x7F, 0x04, 0x08, 0x10, 0x7F, 0x00, // N
-    0x3E, 0x41, 0x41, 0x41, 0x3E, 0x00, // O
-    0x7F, 0x09, 0x09, 0x09, 0x06, 0x00, // P
-    0x3E, 0x41, 0x51, 0x21, 0x5E, 0x00, // Q
-    0x7F, 0x09, 0x19, 0x29, 0x46, 0x00, // R
-    0x26, 0x49, 0x49, 0x49, 0x32, 0x00, // S
-    0x03, 0x01, 0x7F, 0x01, 0x03, 0x00, // T
-    0x3F, 0x40, 0x40, 0x40, 0x3F, 0x00, // U
-    0x1F, 0x20, 0x40, 0x20, 0x1F, 0x00, // V
-    0x3F, 0x40, 0x38, 0x40, 0x3F, 0x00, // W
-    0x63, 0x14, 0x08, 0x14, 0x63, 0x00, // X
-    0x03, 0x04, 0x78, 0x04, 0x03, 0x00, // Y
-    0x61, 0x59, 0x49, 0x4D, 0x43, 0x00, // Z
-    0x00, 0x7F, 0x41, 0x41, 0x41, 0x00, // [
-    0x02, 0x04, 0x08, 0x10, 0x20, 0x00, // backslash
-    0x00, 0x41, 0x41, 0x41, 0x7F, 0x00, // ]
-    0x04, 0x02, 0x01, 0x02, 0x04, 0x00, // ^
-    0x40, 0x40, 0x40, 0x40, 0x40, 0x00, // _
-    0x00, 0x03, 0x07, 0x08, 0x00, 0x00, // `
-    0x20, 0x54, 0x54, 0x78, 0x40, 0x00, // a
-    0x7F, 0x28, 0x44, 0x44, 0x38, 0x00, // b
-    0x38, 0x44, 0x44, 0x44, 0x28, 0x00, // c
-    0x38, 0x44, 0x44, 0x28, 0x7F, 0x00, // d
-    0x38, 0x54, 0x54, 0x54, 0x18, 0x00, // e
-    0x00, 0x08, 0x7E, 0x09, 0x02, 0x00, // f
-    0x18, 0xA4, 0xA4, 0x9C, 0x78, 0x00, // g
-    0x7F, 0x08, 0x04, 0x04, 0x78, 0x00, // h
-    0x00, 0x44, 0x7D, 0x40, 0x00, 0x00, // i
-    0x20, 0x40, 0x40, 0x3D, 0x00, 0x00, // j
-    0x7F, 0x10, 0x28, 0x44, 0x00, 0x00, // k
-    0x00, 0x41, 0x7F, 0x40, 0x00, 0x00, // l
-    0x7C, 0x04, 0x78, 0x04, 0x78, 0x00, // m
-    0x7C, 0x08, 0x04, 0x04, 0x78, 0x00, // n
-    0x38, 0x44, 0x44, 0x44, 0x38, 0x00, // o
-    0xFC, 0x18, 0x24, 0x24, 0x18, 0x00, // p
-    0x18, 0x24, 0x24, 0x18, 0xFC, 0x00, // q
-    0x7C, 0x08, 0x04, 0x04, 0x08, 0x00, // r
-    0x48, 0x54, 0x54, 0x54, 0x24, 0x00, // s
-    0x04, 0x04, 0x3F, 0x44, 0x24, 0x00, // t
-    0x3C, 0x40, 0x40, 0x20, 0x7C, 0x00, // u
-    0x1C, 0x20, 0x40, 0x20, 0x1C, 0x00, // v
-    0x3C, 0x40, 0x30, 0x40, 0x3C, 0x00, // w
-    0x44, 0x28, 0x10, 0x28, 0x44, 0x00, // x
-    0x4C, 0x90, 0x90, 0x90, 0x7C, 0x00, // y
-    0x44, 0x64, 0x54, 0x4C, 0x44, 0x00, // z
-    0x00, 0x08, 0x36, 0x41, 0x00, 0x00, // {
-    0x00, 0x00, 0x77, 0x00, 0x00, 0x00, // |
-    0x00, 0x41, 0x36, 0x08, 0x00, 0x00, // }
-    0x02, 0x01, 0x02, 0x04, 0x02, 0x00, // ~
-};
-
-#define FONT_CHAR_WIDTH 6
-#define FONT_CHAR_HEIGHT 8
-#define FONT_FIRST_CHAR 32
+// One preallocated transmit segment per page. Each segment opens with the
+// COLUMNADDR/PAGEADDR window as Co=1 command pairs followed by the data
+// control byte, so a window and its pixels go out in a single transaction
+// without a per-frame allocation.
+#define SEGMENT_HEADER_LEN 13
+#define FLUSH_PAGES (DISPLAY_PAGES + 1)
+static uint8_t tx_segments[FLUSH_PAGES][SEGMENT_HEADER_LEN + DISPLAY_WIDTH];
+
+typedef struct {
+  uint8_t page;
+  uint8_t first_col;
+  uint8_t last_col;
+} flush_window_t;
+
+static flush_window_t flush_windows[FLUSH_PAGES];
+static int flush_window_count = 0;
+static int flush_start_line = -1; // Start line to set after the data, or -1
+
+static TaskHandle_t flush_task_handle = NULL;
+static SemaphoreHandle_t flush_idle = NULL; // Given when no flush in flight
+static SemaphoreHandle_t bus_mutex = NULL;  // Serializes I2C transactions
+
+// Transaction rate window
+static int64_t tps_window_start_us = 0;
+static uint32_t tps_window_count = 0;
 
 // =============================================================================
 // I2C Helpers
 // =============================================================================
 
-static esp_err_t i2c_write_cmd(uint8_t cmd) {
-  uint8_t data[2] = {SSD1306_CMD, cmd};
-  return i2c_master_write_to_device(I2C_MASTER_NUM, DISPLAY_I2C_ADDR, data, 2,
+static void roll_tps_window(int64_t now) {
+  int64_t elapsed = now - tps_window_start_us;
+  if (elapsed >= 1000000) {
+    stats.transactions_per_sec = (tps_window_count * 1000000LL) / elapsed;
+    tps_window_start_us = now;
+    tps_window_count = 0;
+  }
+}
+
+// Must be called with bus_mutex held
+static esp_err_t i2c_transmit(const uint8_t *buf, size_t len) {
+  stats.transactions++;
+  tps_window_count++;
+  roll_tps_window(esp_timer_get_time());
+
+  return i2c_master_write_to_device(I2C_MASTER_NUM, DISPLAY_I2C_ADDR, buf, len,
                                     pdMS_TO_TICKS(I2C_TIMEOUT_MS));
 }
 
-static esp_err_t i2c_write_data(const uint8_t *data, size_t len) {
-  uint8_t *buf = malloc(len + 1);
-  if (!buf)
-    return ESP_ERR_NO_MEM;
+// =============================================================================
+// Command Streams
+// =============================================================================
+// A command stream packs a whole sequence behind a single Co=0 control byte
+// so it goes out as one I2C transaction instead of one per command byte.
+#define CMD_STREAM_MAX 32
+
+typedef struct {
+  uint8_t buf[1 + CMD_STREAM_MAX];
+  size_t len;
+} cmd_stream_t;
+
+static void cmd_stream_begin(cmd_stream_t *stream) {
+  stream->buf[0] = SSD1306_CMD;
+  stream->len = 1;
+}
+
+static void cmd_stream_put(cmd_stream_t *stream, uint8_t cmd) {
+  if (stream->len < sizeof(stream->buf)) {
+    stream->buf[stream->len++] = cmd;
+  }
+}
+
+static esp_err_t cmd_stream_send(const cmd_stream_t *stream) {
+  xSemaphoreTake(bus_mutex, portMAX_DELAY);
+  esp_err_t ret = i2c_transmit(stream->buf, stream->len);
+  xSemaphoreGive(bus_mutex);
+  return ret;
+}
+
+// =============================================================================
+// Window Segments
+// =============================================================================
 
-  buf[0] = SSD1306_DATA;
-  memcpy(buf + 1, data, len);
+static void segment_init(uint8_t *segment) {
+  static const uint8_t header[SEGMENT_HEADER_LEN] = {
+      SSD1306_CMD_SINGLE, SSD1306_COLUMNADDR, // Column window
+      SSD1306_CMD_SINGLE, 0,                  // First column
+      SSD1306_CMD_SINGLE, 0,                  // Last column
+      SSD1306_CMD_SINGLE, SSD1306_PAGEADDR,   // Page window
+      SSD1306_CMD_SINGLE, 0,                  // First page
+      SSD1306_CMD_SINGLE, 0,                  // Last page
+      SSD1306_DATA,                           // Pixel data follows
+  };
+  memcpy(segment, header, SEGMENT_HEADER_LEN);
+}
 
+static void segment_set_window(uint8_t *segment, const flush_window_t *win) {
+  segment[3] = win->first_col;
+  segment[5] = win->last_col;
+  segment[9] = win->page;
+  segment[11] = win->page;
+}
+
+static esp_err_t write_window(int index) {
+  const flush_window_t *win = &flush_windows[index];
+
+  xSemaphoreTake(bus_mutex, portMAX_DELAY);
   esp_err_t ret =
-      i2c_master_write_to_device(I2C_MASTER_NUM, DISPLAY_I2C_ADDR, buf, len + 1,
-                                 pdMS_TO_TICKS(I2C_TIMEOUT_MS));
-  free(buf);
+      i2c_transmit(tx_segments[index],
+                   SEGMENT_HEADER_LEN + win->last_col - win->first_col + 1);
+  xSemaphoreGive(bus_mutex);
   return ret;
 }
 
+// =============================================================================
+// Flush Task
+// =============================================================================
+
+static void flush_task(void *pvParameters) {
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    int64_t flush_start = esp_timer_get_time();
+
+    for (int i = 0; i < flush_window_count; i++) {
+      if (write_window(i) != ESP_OK) {
+        // Page contents unknown, resend it in full next time
+        panel_valid_pages &= ~(1 << flush_windows[i].page);
+      }
+    }
+
+    // Move the start line only once the exposed rows hold the new content,
+    // so a scroll never shows stale rows for a frame.
+    if (flush_start_line >= 0) {
+      cmd_stream_t stream;
+      cmd_stream_begin(&stream);
+      cmd_stream_put(&stream, SSD1306_SETSTARTLINE | flush_start_line);
+      if (cmd_stream_send(&stream) != ESP_OK) {
+        panel_start_line = -1; // Resend with the next frame
+      }
+    }
+
+    int64_t flush_end = esp_timer_get_time();
+    stats.last_flush_us = flush_end - flush_start;
+    stats.flushes++;
+    if (stats.first_frame_us == 0) {
+      stats.first_frame_us = flush_end;
+    }
+
+    xSemaphoreGive(flush_idle);
+  }
+}
+
 // =============================================================================
 // Initialization
 // =============================================================================
@@ -206,6 +286,17 @@ void display_driver_init(void) {
   ESP_ERROR_CHECK(i2c_param_config(I2C_MASTER_NUM, &conf));
   ESP_ERROR_CHECK(i2c_driver_install(I2C_MASTER_NUM, conf.mode, 0, 0, 0));
 
+  bus_mutex = xSemaphoreCreateMutex();
+  flush_idle = xSemaphoreCreateBinary();
+  xSemaphoreGive(flush_idle);
+
+  for (int page = 0; page < FLUSH_PAGES; page++) {
+    segment_init(tx_segments[page]);
+  }
+
+  xTaskCreate(flush_task, "disp_flush", FLUSH_TASK_STACK, NULL,
+              FLUSH_TASK_PRIORITY, &flush_task_handle);
+
   // Initialize SSD1306
   const uint8_t init_cmds[] = {
       SSD1306_DISPLAYOFF,
@@ -235,12 +326,16 @@ void display_driver_init(void) {
       SSD1306_DISPLAYON,
   };
 
+  cmd_stream_t stream;
+  cmd_stream_begin(&stream);
   for (int i = 0; i < sizeof(init_cmds); i++) {
-    i2c_write_cmd(init_cmds[i]);
+    cmd_stream_put(&stream, init_cmds[i]);
   }
+  cmd_stream_send(&stream);
 
   display_driver_clear();
   display_driver_update();
+  display_driver_wait_flush(I2C_TIMEOUT_MS);
 
   LOG_INFO(TAG, "Display initialized (%dx%d)", DISPLAY_WIDTH, DISPLAY_HEIGHT);
 }
@@ -251,17 +346,231 @@ void display_driver_init(void) {
 
 void display_driver_clear(void) { memset(display_buffer, 0, BUFFER_SIZE); }
 
+void display_driver_save_frame(uint8_t *out) {
+  memcpy(out, display_buffer, BUFFER_SIZE);
+}
+
+void display_driver_draw_slide(const uint8_t *from, int shown,
+                               bool from_left) {
+  if (shown < 0) {
+    shown = 0;
+  } else if (shown > DISPLAY_WIDTH) {
+    shown = DISPLAY_WIDTH;
+  }
+  int hidden = DISPLAY_WIDTH - shown;
+
+  // Pages are column-major, so a sideways shift is a move per page
+  for (int page = 0; page < DISPLAY_PAGES; page++) {
+    uint8_t *row = &display_buffer[page * DISPLAY_WIDTH];
+    const uint8_t *old = &from[page * DISPLAY_WIDTH];
+    if (from_left) {
+      memmove(row, &row[hidden], shown);
+      memcpy(&row[shown], old, hidden);
+    } else {
+      memmove(&row[hidden], row, shown);
+      memcpy(row, &old[shown], hidden);
+    }
+  }
+}
+
+void display_driver_hold_updates(bool hold) { updates_held = hold; }
+
+// Hand the finished frame to readers and continue drawing on a copy of it,
+// since screens build on the previous frame (scrolling, partial redraws).
+static void publish_frame(void) {
+  uint32_t prev = atomic_exchange(&ready_slot, draw_index | FRAME_FRESH);
+  int next = prev & FRAME_INDEX_MASK;
+
+  memcpy(frame_words[next], display_words, BUFFER_SIZE);
+  draw_index = next;
+  display_words = frame_words[next];
+  display_buffer = (uint8_t *)frame_words[next];
+}
+
+// A column of the frame as a word, bit y for row y
+static uint32_t column_bits(int col) {
+  uint32_t bits = 0;
+  for (int page = DISPLAY_PAGES - 1; page >= 0; page--) {
+    bits = (bits << 8) | display_buffer[page * DISPLAY_WIDTH + col];
+  }
+  return bits;
+}
+
+// Rotate a column of the GDDRAM ring so that row becomes bit 0
+static uint64_t rotate_rows(uint64_t bits, int row) {
+  return row ? (bits >> row) | (bits << (GDDRAM_ROWS - row)) : bits;
+}
+
+void display_driver_scroll(int rows) {
+  if (rows == 0) {
+    return;
+  }
+
+  if (rows >= DISPLAY_HEIGHT || rows <= -DISPLAY_HEIGHT) {
+    display_driver_clear(); // Nothing survives, skip the ring rotation
+    return;
+  }
+
+  if (rows % 8 == 0) {
+    int pages = rows / 8;
+    int keep = (DISPLAY_PAGES - (pages > 0 ? pages : -pages)) * DISPLAY_WIDTH;
+    if (pages > 0) {
+      memmove(display_buffer, &display_buffer[pages * DISPLAY_WIDTH], keep);
+      memset(&display_buffer[keep], 0, BUFFER_SIZE - keep);
+    } else {
+      memmove(&display_buffer[BUFFER_SIZE - keep], display_buffer, keep);
+      memset(display_buffer, 0, BUFFER_SIZE - keep);
+    }
+  } else {
+    // Rows straddle pages, so shift each column as a whole
+    for (int col = 0; col < DISPLAY_WIDTH; col++) {
+      uint32_t bits = column_bits(col);
+      bits = (rows > 0) ? bits >> rows : bits << -rows;
+      for (int page = 0; page < DISPLAY_PAGES; page++) {
+        display_buffer[page * DISPLAY_WIDTH + col] = bits >> (page * 8);
+      }
+    }
+  }
+
+  scroll_base = (scroll_base + rows + GDDRAM_ROWS) % GDDRAM_ROWS;
+}
+
+// Diff the pages and columns that may have changed against the panel shadow
+// and hand the changed spans to the flush task. GDDRAM pages whose shadow is
+// not valid are sent in full wherever they are.
+static void stage_frame(int first_page, int last_page, int first_col,
+                        int last_col) {
+  // Wait for the previous frame to leave the staging segments
+  xSemaphoreTake(flush_idle, portMAX_DELAY);
+
+  uint32_t frame_bytes = 0;
+  flush_window_count = 0;
+
+  uint64_t region_rows = 0;
+  if (first_page <= last_page) {
+    region_rows = (((uint64_t)1 << ((last_page + 1) * 8)) - 1) &
+                  ~(((uint64_t)1 << (first_page * 8)) - 1);
+  }
+
+  for (int ram_page = 0; ram_page < GDDRAM_PAGES; ram_page++) {
+    // Frame row shown by the first row of this GDDRAM page, and which of
+    // its rows are on screen at all
+    int first_row = (ram_page * 8 - scroll_base + GDDRAM_ROWS) % GDDRAM_ROWS;
+    uint8_t shown = rotate_rows(SCREEN_ROWS, first_row);
+    if (!shown) {
+      continue;
+    }
+
+    uint8_t *shadow = &panel_buffer[ram_page * DISPLAY_WIDTH];
+    const uint8_t *src;
+    if (first_row % 8 == 0) {
+      src = &display_buffer[(first_row / 8) * DISPLAY_WIDTH];
+    } else {
+      // Gather the frame rows that land in this page; rows off screen keep
+      // what the panel already holds
+      static uint8_t gathered[DISPLAY_WIDTH];
+      for (int col = 0; col < DISPLAY_WIDTH; col++) {
+        uint8_t bits = rotate_rows(column_bits(col), first_row);
+        gathered[col] = (bits & shown) | (shadow[col] & ~shown);
+      }
+      src = gathered;
+    }
+
+    int first = 0;
+    int last = DISPLAY_WIDTH - 1;
+
+    // Narrow the window to the changed column span of this page
+    if (panel_valid_pages & (1 << ram_page)) {
+      if (!(uint8_t)rotate_rows(region_rows, first_row)) {
+        continue; // Outside the region, unchanged by contract
+      }
+      first = first_col;
+      while (first <= last_col && src[first] == shadow[first]) {
+        first++;
+      }
+      if (first > last_col) {
+        continue; // Page unchanged
+      }
+      last = last_col;
+      while (src[last] == shadow[last]) {
+        last--;
+      }
+    }
+
+    int len = last - first + 1;
+    uint8_t *segment = tx_segments[flush_window_count];
+    flush_window_t *win = &flush_windows[flush_window_count++];
+    *win = (flush_window_t){
+        .page = ram_page, .first_col = first, .last_col = last};
+
+    segment_set_window(segment, win);
+    memcpy(&segment[SEGMENT_HEADER_LEN], &src[first], len);
+    memcpy(&shadow[first], &src[first], len);
+    frame_bytes += len;
+
+    // Shadow describes this page once the flush lands; the flush task
+    // clears the bit again if the transfer fails.
+    panel_valid_pages |= 1 << ram_page;
+  }
+
+  int start_line = scroll_base;
+  flush_start_line = (start_line != panel_start_line) ? start_line : -1;
+  panel_start_line = start_line;
+
+  publish_frame();
+
+  stats.frames++;
+  stats.last_frame_bytes = frame_bytes;
+  stats.last_frame_transactions =
+      flush_window_count + (flush_start_line >= 0 ? 1 : 0);
+  stats.total_bytes += frame_bytes;
+
+  if (flush_window_count == 0 && flush_start_line < 0) {
+    stats.frames_unchanged++;
+    xSemaphoreGive(flush_idle);
+    return;
+  }
+
+  xTaskNotifyGive(flush_task_handle);
+}
+
 void display_driver_update(void) {
-  // Set column and page addresses
-  i2c_write_cmd(SSD1306_COLUMNADDR);
-  i2c_write_cmd(0);
-  i2c_write_cmd(DISPLAY_WIDTH - 1);
-  i2c_write_cmd(SSD1306_PAGEADDR);
-  i2c_write_cmd(0);
-  i2c_write_cmd((DISPLAY_HEIGHT / 8) - 1);
+  if (updates_held) {
+    return;
+  }
+  stage_frame(0, DISPLAY_PAGES - 1, 0, DISPLAY_WIDTH - 1);
+}
+
+void display_driver_update_region(int x, int y, int width, int height) {
+  if (updates_held) {
+    return;
+  }
+  int x0 = (x < 0) ? 0 : x;
+  int y0 = (y < 0) ? 0 : y;
+  int x1 = (x + width > DISPLAY_WIDTH) ? DISPLAY_WIDTH : x + width;
+  int y1 = (y + height > DISPLAY_HEIGHT) ? DISPLAY_HEIGHT : y + height;
 
-  // Write buffer
-  i2c_write_data(display_buffer, BUFFER_SIZE);
+  if (x0 >= x1 || y0 >= y1) {
+    stage_frame(0, -1, 0, -1); // Only pages the shadow lost, if any
+    return;
+  }
+
+  stage_frame(y0 / 8, (y1 - 1) / 8, x0, x1 - 1);
+}
+
+bool display_driver_wait_flush(uint32_t timeout_ms) {
+  if (xSemaphoreTake(flush_idle, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+    return false;
+  }
+  xSemaphoreGive(flush_idle);
+  return true;
+}
+
+void display_driver_get_stats(display_stats_t *out) {
+  xSemaphoreTake(bus_mutex, portMAX_DELAY);
+  roll_tps_window(esp_timer_get_time()); // Let the rate decay while idle
+  *out = stats;
+  xSemaphoreGive(bus_mutex);
 }
 
 void display_driver_set_pixel(int x, int y, bool on) {
@@ -280,61 +589,128 @@ void display_driver_set_pixel(int x, int y, bool on) {
 // Text Rendering
 // =============================================================================
 
-static void draw_char(int x, int y, char c, int scale) {
-  if (c < FONT_FIRST_CHAR || c > 127) {
-    c = ' ';
+// Horizontal clip for glyph blits, narrowed while drawing a text window
+static int clip_x0 = 0;
+static int clip_x1 = DISPLAY_WIDTH;
+
+static const font_t *font_for_size(calx_text_size_t size) {
+  switch (size) {
+  case TEXT_SIZE_SMALL:
+    return &font_5x7;
+  case TEXT_SIZE_NORMAL:
+    return &font_6x8;
+  case TEXT_SIZE_MEDIUM:
+    return &font_8x12;
+  case TEXT_SIZE_LARGE:
+    return &font_12x16;
+  default:
+    return &font_6x8;
   }
+}
 
-  int idx = (c - FONT_FIRST_CHAR) * FONT_CHAR_WIDTH;
+// ASCII is indexed directly; anything else is a binary search over the
+// sorted extended code points. Control characters draw as spaces, anything
+// else without a glyph as '?'.
+static int glyph_index(const font_t *font, uint32_t code) {
+  if (code < font->first_char) {
+    return ' ' - font->first_char;
+  }
+  if (code < font->first_char + font->glyph_count) {
+    return code - font->first_char;
+  }
 
-  for (int col = 0; col < FONT_CHAR_WIDTH; col++) {
-    uint8_t line = font_6x8[idx + col];
-    for (int row = 0; row < 8; row++) {
-      if (line & (1 << row)) {
-        // Draw scaled pixel
-        for (int sx = 0; sx < scale; sx++) {
-          for (int sy = 0; sy < scale; sy++) {
-            display_driver_set_pixel(x + col * scale + sx, y + row * scale + sy,
-                                     true);
-          }
-        }
-      }
+  int lo = 0;
+  int hi = font->ext_count - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) >> 1;
+    uint32_t probe = font->ext_codes[mid];
+    if (probe == code) {
+      return font->glyph_count + mid;
+    }
+    if (probe < code) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
     }
   }
+  return '?' - font->first_char;
 }
 
-void display_driver_draw_text(int x, int y, const char *text,
-                              calx_text_size_t size) {
-  int scale = 1;
-  switch (size) {
-  case TEXT_SIZE_SMALL:
-    scale = 1;
-    break;
-  case TEXT_SIZE_NORMAL:
-    scale = 1;
-    break; // Could use 1.5x with custom handling
-  case TEXT_SIZE_LARGE:
-    scale = 2;
-    break;
+// Atlas rows use the SSD1306 page layout (column-major, bit 0 at the top), so
+// a glyph column is OR'ed straight into the buffer. When y is not a multiple
+// of 8 each column is split across two pages with a shift.
+static void blit_row(int x, int y, const uint8_t *cols, int width) {
+  if (y <= -8 || y >= DISPLAY_HEIGHT) {
+    return;
   }
 
-  int char_width = display_driver_get_char_width(size);
+  int first = (x < clip_x0) ? clip_x0 - x : 0;
+  int last = (x + width > clip_x1) ? clip_x1 - x : width;
+  int page = y >> 3;
+  int shift = y & 7;
 
-  while (*text) {
-    draw_char(x, y, *text, scale);
-    x += char_width;
-    text++;
+  if (shift == 0) {
+    uint8_t *dst = &display_buffer[page * DISPLAY_WIDTH + x];
+    for (int c = first; c < last; c++) {
+      dst[c] |= cols[c];
+    }
+    return;
+  }
+
+  uint8_t *upper =
+      (page >= 0) ? &display_buffer[page * DISPLAY_WIDTH + x] : NULL;
+  uint8_t *lower = (page + 1 < DISPLAY_PAGES)
+                       ? &display_buffer[(page + 1) * DISPLAY_WIDTH + x]
+                       : NULL;
+
+  for (int c = first; c < last; c++) {
+    if (upper) {
+      upper[c] |= cols[c] << shift;
+    }
+    if (lower) {
+      lower[c] |= cols[c] >> (8 - shift);
+    }
+  }
+}
+
+// Draw one glyph, one atlas row per page
+static void draw_glyph(int x, int y, const font_t *font, int idx) {
+  const uint8_t *glyph = &font->bitmap[font->offset[idx]];
+  int width = (font->offset[idx + 1] - font->offset[idx]) / font->pages;
 
-    if (x + char_width > DISPLAY_WIDTH) {
+  for (int p = 0; p < font->pages; p++) {
+    blit_row(x, y + p * 8, &glyph[p * width], width);
+  }
+}
+
+// Draw glyphs up to the NUL, or up to end if it isn't NULL
+static void draw_run(int x, int y, const char *text, const char *end,
+                     calx_text_size_t size) {
+  const font_t *font = font_for_size(size);
+
+  while (*text && (!end || text < end)) {
+    int idx = glyph_index(font, utf8_next(&text));
+    if (x + font->advance[idx] > DISPLAY_WIDTH) {
       break; // Clip to screen
     }
+    draw_glyph(x, y, font, idx);
+    x += font->advance[idx];
   }
 }
 
+void display_driver_draw_text(int x, int y, const char *text,
+                              calx_text_size_t size) {
+  draw_run(x, y, text, NULL, size);
+}
+
+void display_driver_draw_text_len(int x, int y, const char *text, int len,
+                                  calx_text_size_t size) {
+  draw_run(x, y, text, text + len, size);
+}
+
 void display_driver_draw_text_centered(int y, const char *text,
                                        calx_text_size_t size) {
-  int char_width = display_driver_get_char_width(size);
-  int text_width = strlen(text) * char_width;
+  int text_width = display_driver_get_text_width(text, size);
   int x = (DISPLAY_WIDTH - text_width) / 2;
   if (x < 0)
     x = 0;
@@ -342,22 +718,117 @@ void display_driver_draw_text_centered(int y, const char *text,
   display_driver_draw_text(x, y, text, size);
 }
 
+void display_driver_draw_text_window(int x, int y, int width, const char *text,
+                                     int offset, calx_text_size_t size) {
+  const font_t *font = font_for_size(size);
+
+  clip_x0 = (x < 0) ? 0 : x;
+  clip_x1 = (x + width > DISPLAY_WIDTH) ? DISPLAY_WIDTH : x + width;
+
+  // Glyphs straddling either edge are cut at the column, so the window
+  // can slide a pixel at a time
+  for (int cx = x - offset; *text && cx < clip_x1;) {
+    int idx = glyph_index(font, utf8_next(&text));
+    if (cx + font->advance[idx] > clip_x0) {
+      draw_glyph(cx, y, font, idx);
+    }
+    cx += font->advance[idx];
+  }
+
+  clip_x0 = 0;
+  clip_x1 = DISPLAY_WIDTH;
+}
+
+int display_driver_get_text_width(const char *text, calx_text_size_t size) {
+  const font_t *font = font_for_size(size);
+  int width = 0;
+
+  while (*text) {
+    width += font->advance[glyph_index(font, utf8_next(&text))];
+  }
+  return width;
+}
+
+int display_driver_get_glyph_advance(uint32_t code, calx_text_size_t size) {
+  const font_t *font = font_for_size(size);
+  return font->advance[glyph_index(font, code)];
+}
+
 // =============================================================================
 // Drawing Primitives
 // =============================================================================
 
-void display_driver_draw_hline(int x, int y, int width) {
-  for (int i = 0; i < width; i++) {
-    display_driver_set_pixel(x + i, y, true);
+typedef enum { SPAN_SET, SPAN_CLEAR, SPAN_INVERT } span_op_t;
+
+// Apply a row mask to columns [x0, x1) of one page. The buffer and every
+// page start are word aligned, so the interior of the span is processed
+// four columns per 32-bit word, with bytewise head and tail.
+static void page_span(int page, int x0, int x1, uint8_t mask, span_op_t op) {
+  uint8_t *row = &display_buffer[page * DISPLAY_WIDTH];
+  uint32_t mask32 = mask * 0x01010101u;
+  int x = x0;
+
+  for (; x < x1 && (x & 3); x++) {
+    row[x] = (op == SPAN_SET)     ? (row[x] | mask)
+             : (op == SPAN_CLEAR) ? (row[x] & ~mask)
+                                  : (row[x] ^ mask);
+  }
+
+  uint32_t *word = &display_words[(page * DISPLAY_WIDTH + x) / 4];
+  int words = (x1 - x) / 4;
+  switch (op) {
+  case SPAN_SET:
+    for (int i = 0; i < words; i++) {
+      word[i] |= mask32;
+    }
+    break;
+  case SPAN_CLEAR:
+    for (int i = 0; i < words; i++) {
+      word[i] &= ~mask32;
+    }
+    break;
+  case SPAN_INVERT:
+    for (int i = 0; i < words; i++) {
+      word[i] ^= mask32;
+    }
+    break;
+  }
+  x += words * 4;
+
+  for (; x < x1; x++) {
+    row[x] = (op == SPAN_SET)     ? (row[x] | mask)
+             : (op == SPAN_CLEAR) ? (row[x] & ~mask)
+                                  : (row[x] ^ mask);
   }
 }
 
-void display_driver_draw_vline(int x, int y, int height) {
-  for (int i = 0; i < height; i++) {
-    display_driver_set_pixel(x, y + i, true);
+static void rect_op(int x, int y, int width, int height, span_op_t op) {
+  int x0 = (x < 0) ? 0 : x;
+  int y0 = (y < 0) ? 0 : y;
+  int x1 = (x + width > DISPLAY_WIDTH) ? DISPLAY_WIDTH : x + width;
+  int y1 = (y + height > DISPLAY_HEIGHT) ? DISPLAY_HEIGHT : y + height;
+
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+
+  for (int page = y0 >> 3; page <= (y1 - 1) >> 3; page++) {
+    int top = (y0 > page * 8) ? y0 - page * 8 : 0;
+    int bottom = (y1 < page * 8 + 8) ? y1 - page * 8 : 8;
+    uint8_t mask = ((1 << bottom) - 1) & ~((1 << top) - 1);
+
+    page_span(page, x0, x1, mask, op);
   }
 }
 
+void display_driver_draw_hline(int x, int y, int width) {
+  rect_op(x, y, width, 1, SPAN_SET);
+}
+
+void display_driver_draw_vline(int x, int y, int height) {
+  rect_op(x, y, 1, height, SPAN_SET);
+}
+
 void display_driver_draw_rect(int x, int y, int width, int height) {
   display_driver_draw_hline(x, y, width);
   display_driver_draw_hline(x, y + height - 1, width);
@@ -366,20 +837,11 @@ void display_driver_draw_rect(int x, int y, int width, int height) {
 }
 
 void display_driver_fill_rect(int x, int y, int width, int height, bool on) {
-  for (int i = 0; i < width; i++) {
-    for (int j = 0; j < height; j++) {
-      display_driver_set_pixel(x + i, y + j, on);
-    }
-  }
+  rect_op(x, y, width, height, on ? SPAN_SET : SPAN_CLEAR);
 }
 
 void display_driver_invert_rect(int x, int y, int width, int height) {
-  for (int px = x; px < x + width && px < DISPLAY_WIDTH; px++) {
-    for (int py = y; py < y + height && py < DISPLAY_HEIGHT; py++) {
-      int idx = px + (py / 8) * DISPLAY_WIDTH;
-      display_buffer[idx] ^= (1 << (py & 7));
-    }
-  }
+  rect_op(x, y, width, height, SPAN_INVERT);
 }
 
 // =============================================================================
@@ -387,12 +849,18 @@ void display_driver_invert_rect(int x, int y, int width, int height) {
 // =============================================================================
 
 void display_driver_power(bool on) {
-  i2c_write_cmd(on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF);
+  cmd_stream_t stream;
+  cmd_stream_begin(&stream);
+  cmd_stream_put(&stream, on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF);
+  cmd_stream_send(&stream);
 }
 
 void display_driver_set_contrast(uint8_t contrast) {
-  i2c_write_cmd(SSD1306_SETCONTRAST);
-  i2c_write_cmd(contrast);
+  cmd_stream_t stream;
+  cmd_stream_begin(&stream);
+  cmd_stream_put(&stream, SSD1306_SETCONTRAST);
+  cmd_stream_put(&stream, contrast);
+  cmd_stream_send(&stream);
 }
 
 // =============================================================================
@@ -400,16 +868,7 @@ void display_driver_set_contrast(uint8_t contrast) {
 // =============================================================================
 
 int display_driver_get_char_width(calx_text_size_t size) {
-  switch (size) {
-  case TEXT_SIZE_SMALL:
-    return 6;
-  case TEXT_SIZE_NORMAL:
-    return 6;
-  case TEXT_SIZE_LARGE:
-    return 12;
-  default:
-    return 6;
-  }
+  return font_for_size(size)->width;
 }
 
 int display_driver_get_line_height(calx_text_size_t size) {
@@ -418,6 +877,8 @@ int display_driver_get_line_height(calx_text_size_t size) {
     return 8;
   case TEXT_SIZE_NORMAL:
     return 10;
+  case TEXT_SIZE_MEDIUM:
+    return 12;
   case TEXT_SIZE_LARGE:
     return 16;
   default:
@@ -429,7 +890,13 @@ int display_driver_get_line_height(calx_text_size_t size) {
 // Buffer Access (for web display streaming)
 // =============================================================================
 
-const uint8_t *display_driver_get_buffer(void) { return display_buffer; }
+const uint8_t *display_driver_get_buffer(void) {
+  // Take the newest frame if there is one, giving back the buffer we held
+  if (atomic_load(&ready_slot) & FRAME_FRESH) {
+    read_index = atomic_exchange(&ready_slot, read_index) & FRAME_INDEX_MASK;
+  }
+  return (const uint8_t *)frame_words[read_index];
+}
 
 void display_driver_draw_bitmap(int x, int y, const uint8_t *bitmap, int w,
                                 int h) {
@@ -11,6 +11,22 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/**
+ * Flush statistics (bytes are framebuffer payload, excluding commands)
+ */
+typedef struct {
+  uint32_t frames;                  // display_driver_update() calls
+  uint32_t frames_unchanged;        // Updates that found nothing to send
+  uint32_t last_frame_bytes;        // Payload bytes sent by the last update
+  uint32_t last_frame_transactions; // I2C transactions for the last update
+  uint32_t total_bytes;             // Payload bytes sent since boot
+  uint32_t transactions;            // I2C transactions issued since boot
+  uint32_t transactions_per_sec;    // Rate over the last full second
+  uint32_t flushes;                 // Frames the flush task has sent
+  uint32_t last_flush_us;           // Bus time of the last flush
+  int64_t first_frame_us;           // Boot to first frame on the panel
+} display_stats_t;
+
 /**
  * Initialize the SSD1306 OLED display
  */
@@ -21,18 +37,82 @@ void display_driver_init(void);
  */
 void display_driver_clear(void);
 
+/**
+ * Scroll the buffer contents by a number of rows
+ * Positive values move content up, negative down; the exposed rows are
+ * cleared for the caller to draw. The panel follows by moving its display
+ * start line, so the next update only sends the exposed rows (and, when the
+ * scroll is not a multiple of 8, the rest of the pages they fall in).
+ * @param rows Number of rows to scroll
+ */
+void display_driver_scroll(int rows);
+
+/**
+ * Copy the frame being drawn
+ * @param out DISPLAY_BUFFER_SIZE bytes
+ */
+void display_driver_save_frame(uint8_t *out);
+
+/**
+ * Slide the frame being drawn in over a saved one
+ * The drawn frame enters from the right edge (the left if from_left) with
+ * shown columns of it visible, pushing the saved frame out ahead of it.
+ * @param from Frame being pushed out, from display_driver_save_frame()
+ * @param shown Columns of the drawn frame on screen, 0 to DISPLAY_WIDTH
+ * @param from_left Enter from the left edge
+ */
+void display_driver_draw_slide(const uint8_t *from, int shown,
+                               bool from_left);
+
+/**
+ * Hold back updates while a frame is composed in several passes
+ * While held, display_driver_update() and display_driver_update_region()
+ * send nothing; call display_driver_update() once released.
+ * @param hold true to hold, false to release
+ */
+void display_driver_hold_updates(bool hold);
+
 /**
  * Update display with buffer contents
+ * Only the column span that changed since the last update is sent for each
+ * page; unchanged pages are skipped entirely. The changed spans are staged
+ * and handed to the flush task, so this returns without waiting for the bus
+ * (it only blocks if the previous frame is still being sent).
  */
 void display_driver_update(void);
 
+/**
+ * Update display after drawing only inside a rectangle
+ * Like display_driver_update() but only the pages and columns the
+ * rectangle covers are compared with the panel, so pixels outside it must
+ * be unchanged since the last update.
+ * @param x Left edge
+ * @param y Top edge
+ * @param width Width in pixels
+ * @param height Height in pixels
+ */
+void display_driver_update_region(int x, int y, int width, int height);
+
+/**
+ * Wait for the frame handed off by display_driver_update() to reach the panel
+ * @param timeout_ms Maximum time to wait
+ * @return true if no flush is in flight
+ */
+bool display_driver_wait_flush(uint32_t timeout_ms);
+
+/**
+ * Get flush statistics
+ * @param out Output structure
+ */
+void display_driver_get_stats(display_stats_t *out);
+
 /**
  * Set a pixel in the buffer
  */
 void display_driver_set_pixel(int x, int y, bool on);
 
 /**
- * Draw text at position with specified size
+ * Draw UTF-8 text at position with specified size
  * @param x X position
  * @param y Y position
  * @param text Text to draw
@@ -41,6 +121,17 @@ void display_driver_set_pixel(int x, int y, bool on);
 void display_driver_draw_text(int x, int y, const char *text,
                               calx_text_size_t size);
 
+/**
+ * Draw at most len bytes of UTF-8 text, e.g. one line inside a longer text
+ * @param x X position
+ * @param y Y position
+ * @param text Text to draw (stops early at a NUL)
+ * @param len Bytes to draw
+ * @param size Text size
+ */
+void display_driver_draw_text_len(int x, int y, const char *text, int len,
+                                  calx_text_size_t size);
+
 /**
  * Draw text centered horizontally
  * @param y Y position
@@ -50,6 +141,30 @@ void display_driver_draw_text(int x, int y, const char *text,
 void display_driver_draw_text_centered(int y, const char *text,
                                        calx_text_size_t size);
 
+/**
+ * Draw text clipped to a horizontal window, for marquee labels
+ * @param x Window left edge
+ * @param y Y position
+ * @param width Window width in pixels
+ * @param text Text to draw
+ * @param offset Pixels of text scrolled out past the left edge
+ * @param size Text size
+ */
+void display_driver_draw_text_window(int x, int y, int width, const char *text,
+                                     int offset, calx_text_size_t size);
+
+/**
+ * Get the width of a string in pixels
+ */
+int display_driver_get_text_width(const char *text, calx_text_size_t size);
+
+/**
+ * Get the advance of a single character in pixels
+ * @param code Unicode code point
+ * @param size Text size
+ */
+int display_driver_get_glyph_advance(uint32_t code, calx_text_size_t size);
+
 /**
  * Draw a horizontal line
  */
@@ -97,7 +212,9 @@ void display_driver_power(bool on);
 void display_driver_set_contrast(uint8_t contrast);
 
 /**
- * Get character width for a text size
+ * Get the widest character cell for a text size
+ * Fonts other than TEXT_SIZE_NORMAL are proportional; measure strings with
+ * display_driver_get_text_width().
  */
 int display_driver_get_char_width(calx_text_size_t size);
 
@@ -107,8 +224,11 @@ int display_driver_get_char_width(calx_text_size_t size);
 int display_driver_get_line_height(calx_text_size_t size);
 
 /**
- * Get read-only access to display buffer for web streaming
- * @return Pointer to display buffer (DISPLAY_BUFFER_SIZE bytes)
+ * Get read-only access to the last complete frame for web streaming
+ * The frame is not copied; it stays valid and unchanged until the next call.
+ * Single reader only: callers on more than one task must serialize their
+ * calls and use of the frame (web_display copies it under a mutex).
+ * @return Pointer to frame (DISPLAY_BUFFER_SIZE bytes)
  */
 const uint8_t *display_driver_get_buffer(void);
 
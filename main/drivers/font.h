@@ -0,0 +1,35 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Font Atlases
+ * =============================================================================
+ * Glyph atlases generated at build time by fonts/fontgen.py. Each glyph is
+ * stored as `pages` rows of column bytes in SSD1306 page layout, packed at
+ * its own width. ASCII glyphs come first and are indexed directly; extended
+ * glyphs follow in the order of the sorted ext_codes table.
+ * =============================================================================
+ */
+
+#ifndef FONT_H
+#define FONT_H
+
+#include <stdint.h>
+
+typedef struct {
+  uint8_t width;              // Widest glyph in columns
+  uint8_t height;             // Cell height in rows
+  uint8_t pages;              // Bytes per glyph column
+  uint8_t first_char;         // Code of the first directly indexed glyph
+  uint8_t glyph_count;        // Directly indexed glyphs
+  uint16_t ext_count;         // Extended glyphs after them
+  const uint16_t *ext_codes;  // Sorted code points of the extended glyphs
+  const uint16_t *offset;     // Start of each glyph in bitmap, plus the end
+  const uint8_t *bitmap;      // Packed glyph columns
+  const uint8_t *advance;     // Per-glyph advance in pixels, spacing included
+} font_t;
+
+extern const font_t font_5x7;   // Proportional, small text
+extern const font_t font_6x8;   // Monospace
+extern const font_t font_8x12;  // Proportional, headings
+extern const font_t font_12x16; // Proportional, large text
+
+#endif // FONT_H
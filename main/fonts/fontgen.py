@@ -0,0 +1,292 @@
+#!/usr/bin/env python3
+"""
+=============================================================================
+CalX ESP32 Firmware - Font Atlas Generator
+=============================================================================
+Builds the firmware's glyph atlases from the master glyph source at build
+time. Larger sizes are derived with pixel-art scalers (Scale2x / Scale3x),
+which smooth diagonals instead of producing blocky pixel doubling.
+
+Atlases are stored page-aligned: each glyph is `pages` rows of column
+bytes, bit 0 at the top, the same layout as an SSD1306 page, so the driver
+copies glyph columns straight into the frame buffer. Glyphs are packed at
+their own width behind an offset table. ASCII is indexed directly; the
+extended glyphs follow in code point order for a binary search.
+
+Usage: fontgen.py <glyphs.txt> <output.c>
+=============================================================================
+"""
+
+import sys
+
+MASTER_WIDTH = 5
+MASTER_HEIGHT = 8
+FIRST_CHAR = 32
+LAST_CHAR = 126
+
+
+# =============================================================================
+# Glyph Source
+# =============================================================================
+
+
+def load_source(path):
+    """Parse the master source into glyphs, marks and derived glyphs."""
+    glyphs = {}   # code point -> rows of 0/1
+    marks = {}    # mark name -> rows of 0/1
+    derived = {}  # code point -> (base code point, mark name or None)
+    target = None
+    rows = []
+
+    with open(path, encoding="utf-8") as f:
+        for line_no, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line or (line.startswith("#") and target is None):
+                continue
+
+            if line.startswith("U+") or line.startswith("MARK "):
+                fields = line.split()
+                if fields[0] == "MARK":
+                    target = (marks, fields[1])
+                elif len(fields) > 3 and fields[2] == "=":
+                    rhs = fields[3:]
+                    base = int(rhs[0][2:], 16)
+                    mark = rhs[2] if len(rhs) == 3 and rhs[1] == "+" else None
+                    derived[int(fields[0][2:], 16)] = (base, mark)
+                    continue
+                else:
+                    target = (glyphs, int(fields[0][2:], 16))
+                rows = []
+                continue
+
+            if target is None or len(line) != MASTER_WIDTH:
+                sys.exit("%s:%d: malformed glyph row" % (path, line_no))
+
+            rows.append([1 if c == "#" else 0 for c in line])
+            if len(rows) == MASTER_HEIGHT:
+                target[0][target[1]] = rows
+                target = None
+
+    for code, (base, mark) in sorted(derived.items()):
+        if base not in glyphs or (mark and mark not in marks):
+            sys.exit("%s: U+%04X derives from a missing glyph" % (path, code))
+        glyphs[code] = compose(glyphs[base], marks[mark]) if mark else \
+            glyphs[base]
+
+    for code in range(FIRST_CHAR, LAST_CHAR + 1):
+        if code not in glyphs:
+            sys.exit("%s: missing glyph U+%04X" % (path, code))
+    return glyphs
+
+
+def compose(base, mark):
+    """Overlay a mark, squashing capitals into rows 2-6 under an accent."""
+    def inked(bm, rows):
+        return any(any(bm[r]) for r in rows)
+
+    if inked(mark, (0, 1)) and inked(base, (0, 1)):
+        blank = [0] * MASTER_WIDTH
+        base = [blank, blank] + [base[r] for r in (0, 1, 3, 4, 6)] + [base[7]]
+
+    return [[b | m for b, m in zip(brow, mrow)]
+            for brow, mrow in zip(base, mark)]
+
+
+# =============================================================================
+# Scalers
+# =============================================================================
+
+
+def pixel(bm, r, c):
+    if 0 <= r < len(bm) and 0 <= c < len(bm[0]):
+        return bm[r][c]
+    return 0
+
+
+def scale2x(bm):
+    """EPX / Scale2x: double the size, rounding off stair-step corners."""
+    h, w = len(bm), len(bm[0])
+    out = [[0] * (w * 2) for _ in range(h * 2)]
+
+    for r in range(h):
+        for c in range(w):
+            p = bm[r][c]
+            a = pixel(bm, r - 1, c)
+            b = pixel(bm, r, c + 1)
+            d = pixel(bm, r, c - 1)
+            e = pixel(bm, r + 1, c)
+            out[2 * r][2 * c] = a if d == a != e and a != b else p
+            out[2 * r][2 * c + 1] = b if a == b != d and b != e else p
+            out[2 * r + 1][2 * c] = d if e == d != b and d != a else p
+            out[2 * r + 1][2 * c + 1] = e if b == e != a and e != d else p
+    return out
+
+
+def scale3x(bm):
+    """Scale3x: triple the size with the same corner rules as Scale2x."""
+    h, w = len(bm), len(bm[0])
+    out = [[0] * (w * 3) for _ in range(h * 3)]
+
+    for r in range(h):
+        for c in range(w):
+            a, b, c3 = (pixel(bm, r - 1, c + i) for i in (-1, 0, 1))
+            d, e, f = (pixel(bm, r, c + i) for i in (-1, 0, 1))
+            g, h2, i9 = (pixel(bm, r + 1, c + i) for i in (-1, 0, 1))
+            px = [e] * 9
+            if b != h2 and d != f:
+                px[0] = d if d == b else e
+                px[1] = b if (d == b and e != c3) or (b == f and e != a) else e
+                px[2] = f if b == f else e
+                px[3] = d if (d == b and e != g) or (d == h2 and e != a) else e
+                px[5] = (f if (b == f and e != i9) or (h2 == f and e != c3)
+                         else e)
+                px[6] = d if d == h2 else e
+                px[7] = (h2 if (d == h2 and e != i9) or (h2 == f and e != g)
+                         else e)
+                px[8] = f if h2 == f else e
+            for k in range(9):
+                out[3 * r + k // 3][3 * c + k % 3] = px[k]
+    return out
+
+
+def halve(bm, threshold):
+    """Box-filter down by 2, keeping pixels whose 2x2 block is mostly on."""
+    h, w = len(bm) // 2, len(bm[0]) // 2
+    out = [[0] * w for _ in range(h)]
+
+    for r in range(h):
+        for c in range(w):
+            block = (bm[2 * r][2 * c] + bm[2 * r][2 * c + 1] +
+                     bm[2 * r + 1][2 * c] + bm[2 * r + 1][2 * c + 1])
+            out[r][c] = 1 if block >= threshold else 0
+    return out
+
+
+# =============================================================================
+# Atlas Building
+# =============================================================================
+
+
+def trim(bm):
+    """Drop blank columns on both sides. Returns (rows, ink width)."""
+    cols = [c for c in range(len(bm[0])) if any(row[c] for row in bm)]
+    if not cols:
+        return [[] for _ in bm], 0
+    return [row[cols[0]:cols[-1] + 1] for row in bm], cols[-1] - cols[0] + 1
+
+
+def pack(bm, columns, pages):
+    """Pack rows into page-major column bytes."""
+    out = []
+    for page in range(pages):
+        for c in range(columns):
+            byte = 0
+            for bit in range(8):
+                r = page * 8 + bit
+                if r < len(bm) and c < len(bm[r]) and bm[r][c]:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+
+def build_atlas(glyphs, codes, width, height, scaler, proportional, spacing,
+                space_advance):
+    pages = (height + 7) // 8
+    bitmap = []
+    offset = []
+    advance = []
+
+    for code in codes:
+        bm = scaler(glyphs[code])
+        if len(bm) > height or len(bm[0]) > width:
+            sys.exit("glyph U+%04X does not fit %dx%d" % (code, width, height))
+
+        if proportional:
+            bm, columns = trim(bm)
+            adv = columns + spacing if columns else space_advance
+        else:
+            columns = adv = width
+
+        offset.append(len(bitmap))
+        bitmap += pack(bm, columns, pages)
+        advance.append(adv)
+
+    offset.append(len(bitmap))
+    return pages, bitmap, offset, advance
+
+
+# Name, cell width, cell height, scaler, proportional, spacing, space advance
+FONTS = [
+    ("font_5x7", 5, 8, lambda g: g, True, 1, 3),
+    ("font_6x8", 6, 8, lambda g: [row + [0] for row in g], False, 0, 6),
+    ("font_8x12", 8, 12, lambda g: halve(scale3x(g), 2), True, 1, 4),
+    ("font_12x16", 12, 16, scale2x, True, 2, 6),
+]
+
+
+# =============================================================================
+# Output
+# =============================================================================
+
+
+def c_array(ctype, name, data, fmt, per_line):
+    lines = ["static const %s %s[] = {" % (ctype, name)]
+    for i in range(0, len(data), per_line):
+        chunk = data[i:i + per_line]
+        lines.append("    " + ", ".join(fmt % v for v in chunk) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: fontgen.py <glyphs.txt> <output.c>")
+
+    glyphs = load_source(sys.argv[1])
+    ext_codes = sorted(c for c in glyphs if c > LAST_CHAR)
+    if ext_codes and ext_codes[-1] > 0xFFFF:
+        sys.exit("extended glyphs must be in the Basic Multilingual Plane")
+    codes = list(range(FIRST_CHAR, LAST_CHAR + 1)) + ext_codes
+
+    out = [
+        "// Generated by fontgen.py from %s - do not edit" %
+        sys.argv[1].replace("\\", "/").split("/")[-1],
+        "",
+        '#include "font.h"',
+        "",
+        c_array("uint16_t", "ext_codes", ext_codes, "0x%04X", 8),
+        "",
+    ]
+
+    for name, width, height, scaler, prop, spacing, space in FONTS:
+        pages, bitmap, offset, advance = build_atlas(
+            glyphs, codes, width, height, scaler, prop, spacing, space)
+        if len(bitmap) > 0xFFFF:
+            sys.exit("%s: bitmap too large for 16-bit offsets" % name)
+
+        out.append(c_array("uint8_t", name + "_bitmap", bitmap, "0x%02X", 12))
+        out.append("")
+        out.append(c_array("uint16_t", name + "_offset", offset, "%d", 12))
+        out.append("")
+        out.append(c_array("uint8_t", name + "_advance", advance, "%d", 16))
+        out.append("")
+        out.append("const font_t %s = {" % name)
+        out.append("    .width = %d," % width)
+        out.append("    .height = %d," % height)
+        out.append("    .pages = %d," % pages)
+        out.append("    .first_char = %d," % FIRST_CHAR)
+        out.append("    .glyph_count = %d," % (LAST_CHAR - FIRST_CHAR + 1))
+        out.append("    .ext_count = %d," % len(ext_codes))
+        out.append("    .ext_codes = ext_codes,")
+        out.append("    .offset = %s_offset," % name)
+        out.append("    .bitmap = %s_bitmap," % name)
+        out.append("    .advance = %s_advance," % name)
+        out.append("};")
+        out.append("")
+
+    with open(sys.argv[2], "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -11,6 +11,7 @@
 #include "esp_http_client.h"
 #include "esp_log.h"
 #include "esp_tls.h"
+#include <stdlib.h>
 #include <string.h>
 
 #include "api_client.h"
@@ -226,7 +227,12 @@ bool api_client_send_heartbeat(void) {
 // Chat
 // =============================================================================
 
-int api_client_fetch_chat(chat_message_t *messages, int max_messages,
+static const char *message_time(const cJSON *msg) {
+  cJSON *timestamp = cJSON_GetObjectItem(msg, "created_at");
+  return cJSON_IsString(timestamp) ? timestamp->valuestring : "";
+}
+
+int api_client_fetch_chat(api_chat_message_cb_t on_message, int max_messages,
                           const char *since) {
   char endpoint[128];
   if (since) {
@@ -246,35 +252,41 @@ int api_client_fetch_chat(chat_message_t *messages, int max_messages,
   int count = 0;
   if (err == ESP_OK && status == 200) {
     cJSON *json = cJSON_Parse(response_buffer);
-    if (json) {
-      cJSON *msgs = cJSON_GetObjectItem(json, "messages");
-      if (cJSON_IsArray(msgs)) {
-        cJSON *msg;
-        cJSON_ArrayForEach(msg, msgs) {
-          if (count >= max_messages)
-            break;
-
-          cJSON *content = cJSON_GetObjectItem(msg, "content");
-          cJSON *sender = cJSON_GetObjectItem(msg, "sender");
-          cJSON *timestamp = cJSON_GetObjectItem(msg, "created_at");
-
-          if (cJSON_IsString(content)) {
-            strncpy(messages[count].content, content->valuestring, 2500);
-            messages[count].content[2500] = '\0';
-          }
-          if (cJSON_IsString(sender)) {
-            strncpy(messages[count].sender, sender->valuestring, 7);
-            messages[count].sender[7] = '\0';
-          }
-          if (cJSON_IsString(timestamp)) {
-            strncpy(messages[count].timestamp, timestamp->valuestring, 24);
-            messages[count].timestamp[24] = '\0';
-          }
-          count++;
+    cJSON *msgs = json ? cJSON_GetObjectItem(json, "messages") : NULL;
+    int total = cJSON_IsArray(msgs) ? cJSON_GetArraySize(msgs) : 0;
+    cJSON **sorted = total ? malloc(total * sizeof(*sorted)) : NULL;
+
+    if (sorted) {
+      // The chat history only takes messages newer than its latest, so
+      // sort oldest first whatever order the server lists them in. ISO
+      // 8601 timestamps in one format compare as strings; insertion keeps
+      // messages with the same time in server order.
+      int n = 0;
+      cJSON *msg;
+      cJSON_ArrayForEach(msg, msgs) {
+        if (!cJSON_IsString(cJSON_GetObjectItem(msg, "content"))) {
+          continue;
+        }
+        int i = n++;
+        while (i > 0 &&
+               strcmp(message_time(sorted[i - 1]), message_time(msg)) > 0) {
+          sorted[i] = sorted[i - 1];
+          i--;
         }
+        sorted[i] = msg;
       }
-      cJSON_Delete(json);
+
+      // Keep the newest ones if there are more than fit
+      for (int i = n > max_messages ? n - max_messages : 0; i < n; i++) {
+        cJSON *sender = cJSON_GetObjectItem(sorted[i], "sender");
+        on_message(cJSON_GetObjectItem(sorted[i], "content")->valuestring,
+                   cJSON_IsString(sender) ? sender->valuestring : "",
+                   message_time(sorted[i]));
+        count++;
+      }
+      free(sorted);
     }
+    cJSON_Delete(json);
   }
 
   esp_http_client_cleanup(client);
@@ -9,12 +9,10 @@
 
 #include <stdbool.h>
 
-// Chat message structure
-typedef struct {
-  char content[2501];
-  char sender[8]; // "DEVICE" or "WEB"
-  char timestamp[25];
-} chat_message_t;
+// Receives each fetched chat message; the strings are only valid during
+// the call
+typedef void (*api_chat_message_cb_t)(const char *content, const char *sender,
+                                      const char *timestamp);
 
 // AI response structure
 typedef struct {
@@ -69,12 +67,14 @@ bool api_client_send_heartbeat(void);
 // === Chat ===
 /**
  * Fetch chat messages
- * @param messages Output array
- * @param max_messages Maximum to fetch
+ * Messages are handed to the callback oldest first, whatever order the
+ * server sends them in.
+ * @param on_message Called for each message
+ * @param max_messages Maximum to hand over; the newest are kept
  * @param since Fetch messages after this timestamp (NULL for all)
  * @return Number of messages fetched
  */
-int api_client_fetch_chat(chat_message_t *messages, int max_messages,
+int api_client_fetch_chat(api_chat_message_cb_t on_message, int max_messages,
                           const char *since);
 
 /**
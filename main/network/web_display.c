@@ -9,18 +9,39 @@
 #include "web_display.h"
 #include "display_driver.h"
 #include "esp_log.h"
+#include "event_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "system_state.h"
+#include "ui_metrics.h"
+#include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "WEB_DISPLAY";
 
+// display_driver_get_buffer() has a single reader slot, but the AP and
+// station servers each run their handlers on their own task
+static SemaphoreHandle_t frame_mutex = NULL;
+
 // =============================================================================
 // Initialization
 // =============================================================================
 
 void web_display_init(void) {
+  if (!frame_mutex) {
+    frame_mutex = xSemaphoreCreateMutex();
+  }
   ESP_LOGI(TAG, "Web display streaming initialized");
 }
 
+// Copy the last complete frame, so a handler formats and sends its own
+// snapshot rather than holding the reader slot for the whole response
+static void snapshot_frame(uint8_t *out) {
+  xSemaphoreTake(frame_mutex, portMAX_DELAY);
+  memcpy(out, display_driver_get_buffer(), DISPLAY_BUFFER_SIZE);
+  xSemaphoreGive(frame_mutex);
+}
+
 // =============================================================================
 // HTTP Handlers
 // =============================================================================
@@ -182,8 +203,9 @@ esp_err_t web_display_handler(httpd_req_t *req) {
 
 esp_err_t web_display_data_handler(httpd_req_t *req) {
   // Get display buffer
-  const uint8_t *buffer = display_driver_get_buffer();
+  uint8_t buffer[DISPLAY_BUFFER_SIZE];
   const int buffer_size = DISPLAY_BUFFER_SIZE;
+  snapshot_frame(buffer);
 
   // Build JSON response with buffer data
   // Format: {"buffer":[byte0,byte1,...]}
@@ -208,3 +230,149 @@ esp_err_t web_display_data_handler(httpd_req_t *req) {
   free(json);
   return ret;
 }
+
+esp_err_t web_display_pbm_handler(httpd_req_t *req) {
+  // Binary PBM (P4): rows of 1-bit pixels, leftmost pixel in the high bit,
+  // 1 = lit. Byte-stable for a given frame, so it can be kept as a golden
+  // image and compared with cmp.
+  uint8_t buffer[DISPLAY_BUFFER_SIZE];
+  static const char header[] = "P4\n128 32\n";
+  uint8_t image[sizeof(header) - 1 + DISPLAY_BUFFER_SIZE];
+
+  snapshot_frame(buffer);
+  memcpy(image, header, sizeof(header) - 1);
+  uint8_t *row = image + sizeof(header) - 1;
+  for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+    // Frame bytes are vertical 8-pixel columns, one page per 8 rows
+    const uint8_t *page = &buffer[(y / 8) * DISPLAY_WIDTH];
+    uint8_t bit = 1 << (y % 8);
+    for (int x = 0; x < DISPLAY_WIDTH; x += 8) {
+      uint8_t packed = 0;
+      for (int i = 0; i < 8; i++) {
+        if (page[x + i] & bit) {
+          packed |= 0x80 >> i;
+        }
+      }
+      *row++ = packed;
+    }
+  }
+
+  // Screen shown and its mean render time, to name and baseline the image
+  calx_state_t screen = system_state_get();
+  ui_screen_metrics_t m;
+  ui_metrics_get(screen, &m);
+  char render_us[12];
+  snprintf(render_us, sizeof(render_us), "%lu",
+           (unsigned long)(m.render_us.count
+                               ? m.render_us.sum / m.render_us.count
+                               : 0));
+
+  httpd_resp_set_type(req, "image/x-portable-bitmap");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  httpd_resp_set_hdr(req, "X-CalX-Screen", ui_metrics_screen_name(screen));
+  httpd_resp_set_hdr(req, "X-CalX-Render-Us", render_us);
+  return httpd_resp_send(req, (const char *)image, sizeof(image));
+}
+
+// Append a histogram as {"count":..,"sum":..,"max":..,"hist":[..]}
+static int format_histogram(char *buf, size_t len, const char *name,
+                            const ui_histogram_t *hist) {
+  int pos = snprintf(buf, len,
+                     "\"%s\":{\"count\":%lu,\"sum\":%llu,\"max\":%lu,"
+                     "\"hist\":[",
+                     name, (unsigned long)hist->count,
+                     (unsigned long long)hist->sum, (unsigned long)hist->max);
+  for (int i = 0; i < UI_METRICS_BUCKETS; i++) {
+    pos += snprintf(buf + pos, len - pos, "%s%lu", i ? "," : "",
+                    (unsigned long)hist->buckets[i]);
+  }
+  pos += snprintf(buf + pos, len - pos, "]}");
+  return pos;
+}
+
+esp_err_t web_display_metrics_handler(httpd_req_t *req) {
+  // Format: {"bounds":{"time_us":[..],"bytes":[..]},"screens":{"idle":{..}}}
+  // Histogram bucket i counts values below bounds[i]; the last bucket
+  // counts the rest. Screens that were never shown are left out.
+  char chunk[768];
+  int pos = snprintf(chunk, sizeof(chunk), "{\"bounds\":{\"time_us\":[");
+  for (int i = 0; i < UI_METRICS_BUCKETS - 1; i++) {
+    pos += snprintf(chunk + pos, sizeof(chunk) - pos, "%s%d", i ? "," : "",
+                    UI_METRICS_TIME_BASE_US << i);
+  }
+  pos += snprintf(chunk + pos, sizeof(chunk) - pos, "],\"bytes\":[");
+  for (int i = 0; i < UI_METRICS_BUCKETS - 1; i++) {
+    pos += snprintf(chunk + pos, sizeof(chunk) - pos, "%s%d", i ? "," : "",
+                    UI_METRICS_BYTES_BASE << i);
+  }
+  snprintf(chunk + pos, sizeof(chunk) - pos, "]},\"screens\":{");
+
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  httpd_resp_sendstr_chunk(req, chunk);
+
+  bool first = true;
+  for (int screen = 0; screen < UI_METRICS_SCREENS; screen++) {
+    ui_screen_metrics_t m;
+    ui_metrics_get(screen, &m);
+    if (m.frames == 0 && m.frames_skipped == 0 && m.frames_dropped == 0) {
+      continue;
+    }
+
+    pos = snprintf(chunk, sizeof(chunk),
+                   "%s\"%s\":{\"frames\":%lu,\"skipped\":%lu,"
+                   "\"dropped\":%lu,\"unchanged\":%lu,",
+                   first ? "" : ",", ui_metrics_screen_name(screen),
+                   (unsigned long)m.frames, (unsigned long)m.frames_skipped,
+                   (unsigned long)m.frames_dropped,
+                   (unsigned long)m.frames_unchanged);
+    pos += format_histogram(chunk + pos, sizeof(chunk) - pos, "render_us",
+                            &m.render_us);
+    chunk[pos++] = ',';
+    pos += format_histogram(chunk + pos, sizeof(chunk) - pos, "flush_us",
+                            &m.flush_us);
+    chunk[pos++] = ',';
+    pos += format_histogram(chunk + pos, sizeof(chunk) - pos, "flush_bytes",
+                            &m.flush_bytes);
+    snprintf(chunk + pos, sizeof(chunk) - pos, "}");
+
+    httpd_resp_sendstr_chunk(req, chunk);
+    first = false;
+  }
+
+  httpd_resp_sendstr_chunk(req, "}}");
+  return httpd_resp_sendstr_chunk(req, NULL);
+}
+
+esp_err_t web_display_trace_handler(httpd_req_t *req) {
+  // Format: trace_header_t, then the records oldest first (event_trace.h)
+  uint32_t end = event_trace_count();
+  uint32_t first = end > EVENT_TRACE_RECORDS ? end - EVENT_TRACE_RECORDS : 0;
+  trace_header_t header = {
+      .magic = EVENT_TRACE_MAGIC,
+      .version = EVENT_TRACE_VERSION,
+      .record_size = sizeof(trace_record_t),
+      .first = first,
+      .count = end - first,
+  };
+
+  httpd_resp_set_type(req, "application/octet-stream");
+  httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+  httpd_resp_send_chunk(req, (const char *)&header, sizeof(header));
+
+  // Records written meanwhile may overwrite the oldest ones; those are
+  // sent as they are now
+  trace_record_t chunk[64];
+  for (uint32_t seq = first; seq != end;) {
+    int n = 0;
+    while (n < 64 && seq != end) {
+      if (!event_trace_get(seq, &chunk[n])) {
+        chunk[n] = (trace_record_t){0};
+      }
+      n++;
+      seq++;
+    }
+    httpd_resp_send_chunk(req, (const char *)chunk, n * sizeof(chunk[0]));
+  }
+  return httpd_resp_send_chunk(req, NULL, 0);
+}
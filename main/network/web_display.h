@@ -13,3 +13,6 @@
 void web_display_init(void);
 esp_err_t web_display_handler(httpd_req_t *req);
 esp_err_t web_display_data_handler(httpd_req_t *req);
+esp_err_t web_display_pbm_handler(httpd_req_t *req);
+esp_err_t web_display_metrics_handler(httpd_req_t *req);
+esp_err_t web_display_trace_handler(httpd_req_t *req);
@@ -34,6 +34,11 @@ static const char *TAG = "WIFI";
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT BIT1
 
+// =============================================================================
+// HTTP Server
+// =============================================================================
+#define HTTP_MAX_URI_HANDLERS 12 // Default is 8; the AP portal registers eleven
+
 // =============================================================================
 // State
 // =============================================================================
@@ -367,6 +372,10 @@ void wifi_manager_start_ap(void) {
   // Start HTTP server for captive portal
   httpd_config_t config = HTTPD_DEFAULT_CONFIG();
   config.uri_match_fn = httpd_uri_match_wildcard;
+  config.max_uri_handlers = HTTP_MAX_URI_HANDLERS;
+
+  // Before any request can reach the display handlers
+  web_display_init();
 
   if (httpd_start(&http_server, &config) == ESP_OK) {
     // Root page
@@ -424,6 +433,30 @@ void wifi_manager_start_ap(void) {
     };
     httpd_register_uri_handler(http_server, &display_data);
 
+    // Frame as a PBM image, e.g. for golden-image comparisons
+    httpd_uri_t display_pbm = {
+        .uri = "/display.pbm",
+        .method = HTTP_GET,
+        .handler = web_display_pbm_handler,
+    };
+    httpd_register_uri_handler(http_server, &display_pbm);
+
+    // UI render metrics
+    httpd_uri_t metrics = {
+        .uri = "/metrics",
+        .method = HTTP_GET,
+        .handler = web_display_metrics_handler,
+    };
+    httpd_register_uri_handler(http_server, &metrics);
+
+    // Event trace dump, for replay on a host build
+    httpd_uri_t trace = {
+        .uri = "/trace.bin",
+        .method = HTTP_GET,
+        .handler = web_display_trace_handler,
+    };
+    httpd_register_uri_handler(http_server, &trace);
+
     // Status endpoint
     httpd_uri_t status = {
         .uri = "/status",
@@ -434,7 +467,6 @@ void wifi_manager_start_ap(void) {
   }
 
   LOG_INFO(TAG, "AP started: %s", WIFI_AP_SSID);
-  web_display_init();
 }
 
 void wifi_manager_stop_ap(void) {
@@ -508,6 +540,10 @@ void wifi_manager_start_webserver(void) {
 
   httpd_config_t config = HTTPD_DEFAULT_CONFIG();
   config.uri_match_fn = httpd_uri_match_wildcard;
+  config.max_uri_handlers = HTTP_MAX_URI_HANDLERS;
+
+  // Before any request can reach the display handlers
+  web_display_init();
 
   if (httpd_start(&http_server, &config) == ESP_OK) {
     // Keypress endpoint for web display
@@ -534,8 +570,31 @@ void wifi_manager_start_webserver(void) {
     };
     httpd_register_uri_handler(http_server, &display_data);
 
+    // Frame as a PBM image, e.g. for golden-image comparisons
+    httpd_uri_t display_pbm = {
+        .uri = "/display.pbm",
+        .method = HTTP_GET,
+        .handler = web_display_pbm_handler,
+    };
+    httpd_register_uri_handler(http_server, &display_pbm);
+
+    // UI render metrics
+    httpd_uri_t metrics = {
+        .uri = "/metrics",
+        .method = HTTP_GET,
+        .handler = web_display_metrics_handler,
+    };
+    httpd_register_uri_handler(http_server, &metrics);
+
+    // Event trace dump, for replay on a host build
+    httpd_uri_t trace = {
+        .uri = "/trace.bin",
+        .method = HTTP_GET,
+        .handler = web_display_trace_handler,
+    };
+    httpd_register_uri_handler(http_server, &trace);
+
     LOG_INFO(TAG, "Web server started on port 80");
-    web_display_init();
   } else {
     LOG_ERROR(TAG, "Failed to start web server");
   }
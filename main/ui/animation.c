@@ -0,0 +1,127 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Animation
+ * =============================================================================
+ * Running animations form a singly linked list through the animations
+ * themselves, so the scheduler needs no storage of its own. Values are
+ * computed from the elapsed time, not accumulated per frame, so a late
+ * frame skips ahead instead of slowing the animation down.
+ * =============================================================================
+ */
+
+#include "freertos/task.h"
+
+#include "animation.h"
+
+// =============================================================================
+// State
+// =============================================================================
+static animation_t *running = NULL;
+static TickType_t last_frame = 0;
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static void remove_running(animation_t *anim) {
+  for (animation_t **link = &running; *link; link = &(*link)->next) {
+    if (*link == anim) {
+      *link = anim->next;
+      break;
+    }
+  }
+  anim->next = NULL;
+  anim->running = false;
+}
+
+// Value elapsed_ms into an animation that hasn't reached its end
+static int value_at(const animation_t *anim, uint32_t elapsed_ms) {
+  int64_t delta = anim->to - anim->from;
+  int64_t d = anim->duration_ms;
+
+  if (anim->easing == EASE_OUT) {
+    int64_t left = d - elapsed_ms;
+    return anim->to - (int)(delta * left * left / (d * d));
+  }
+  return anim->from + (int)(delta * elapsed_ms / d);
+}
+
+// =============================================================================
+// Control
+// =============================================================================
+
+void animation_start(animation_t *anim, int from, int to,
+                     uint32_t duration_ms, animation_easing_t easing,
+                     bool loop) {
+  TickType_t now = xTaskGetTickCount();
+  if (!running) {
+    last_frame = now; // First frame one period from now
+  }
+  if (!anim->running) {
+    anim->next = running;
+    running = anim;
+    anim->running = true;
+  }
+
+  anim->from = from;
+  anim->to = to;
+  anim->value = from;
+  anim->duration_ms = duration_ms ? duration_ms : 1;
+  anim->start = now;
+  anim->easing = easing;
+  anim->loop = loop;
+}
+
+void animation_stop(animation_t *anim) {
+  if (anim->running) {
+    remove_running(anim);
+  }
+}
+
+void animation_stop_all(void) {
+  while (running) {
+    remove_running(running);
+  }
+}
+
+// =============================================================================
+// Scheduling
+// =============================================================================
+
+bool animation_tick(void) {
+  TickType_t now = xTaskGetTickCount();
+  bool changed = false;
+  last_frame = now;
+
+  animation_t *anim = running;
+  while (anim) {
+    animation_t *next = anim->next;
+    uint32_t elapsed = pdTICKS_TO_MS(now - anim->start);
+    int value;
+
+    if (elapsed < anim->duration_ms) {
+      value = value_at(anim, elapsed);
+    } else if (anim->loop) {
+      value = value_at(anim, elapsed % anim->duration_ms);
+    } else {
+      value = anim->to;
+      remove_running(anim);
+    }
+
+    if (value != anim->value) {
+      anim->value = value;
+      changed = true;
+    }
+    anim = next;
+  }
+  return changed;
+}
+
+TickType_t animation_ticks_until_frame(void) {
+  if (!running) {
+    return portMAX_DELAY;
+  }
+  TickType_t elapsed = xTaskGetTickCount() - last_frame;
+  TickType_t period = pdMS_TO_TICKS(ANIMATION_FRAME_MS);
+  return (elapsed >= period) ? 0 : period - elapsed;
+}
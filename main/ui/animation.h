@@ -0,0 +1,79 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Animation Header
+ * =============================================================================
+ * Timed integer tweens for the UI task. Animations are owned by the caller
+ * and linked into the scheduler only while they run, so the UI task wakes
+ * at the animation frame rate while something moves and not at all
+ * otherwise. Only call from the UI task.
+ * =============================================================================
+ */
+
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ANIMATION_FRAME_MS 50 // 20 fps while anything animates
+
+typedef enum {
+  EASE_LINEAR = 0,
+  EASE_OUT // Quadratic, slowing down towards the end
+} animation_easing_t;
+
+typedef struct animation animation_t;
+
+/**
+ * One tween from one value to another over a fixed time
+ * value is updated by animation_tick(); read it when rendering.
+ */
+struct animation {
+  int from, to;
+  int value;
+  uint32_t duration_ms;
+  TickType_t start;
+  animation_easing_t easing;
+  bool loop; // Start over at from instead of stopping at to
+  bool running;
+  animation_t *next; // Scheduler list
+};
+
+/**
+ * Start (or restart) an animation at from
+ * @param anim Animation to start
+ * @param from Start value
+ * @param to End value
+ * @param duration_ms Time from start to end value
+ * @param easing Curve between them
+ * @param loop Repeat until stopped
+ */
+void animation_start(animation_t *anim, int from, int to,
+                     uint32_t duration_ms, animation_easing_t easing,
+                     bool loop);
+
+/**
+ * Stop an animation, keeping its current value
+ */
+void animation_stop(animation_t *anim);
+
+/**
+ * Stop every running animation, e.g. when the screen changes
+ */
+void animation_stop_all(void);
+
+/**
+ * Advance all running animations to the current time
+ * Finished animations end on their to value and leave the scheduler.
+ * @return true if any value changed, i.e. a redraw is needed
+ */
+bool animation_tick(void);
+
+/**
+ * Get the time until the next animation frame is due
+ * @return Ticks to wait, portMAX_DELAY if nothing is running
+ */
+TickType_t animation_ticks_until_frame(void);
+
+#endif // ANIMATION_H
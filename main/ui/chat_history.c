@@ -0,0 +1,266 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Chat History
+ * =============================================================================
+ * Messages are stored back to back, NUL-terminated, in a text arena in the
+ * order they arrived. The index holds each message's place in the arena
+ * plus its sender and time. Evicting the oldest messages slides the rest
+ * of the arena down.
+ * =============================================================================
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "chat_history.h"
+#include "display_driver.h"
+#include "logger.h"
+#include "text_renderer.h"
+
+static const char *TAG = "CHAT";
+
+// =============================================================================
+// Configuration
+// =============================================================================
+#define CHAT_ARENA_SIZE 4096
+#define CHAT_MESSAGE_MAX (CHAT_ARENA_SIZE / 2) // Longer messages are cut
+#define CHAT_HEADER_HEIGHT 8
+
+// =============================================================================
+// State
+// =============================================================================
+typedef struct {
+  uint16_t offset; // Start in the arena
+  uint16_t length; // Bytes including the NUL
+  bool from_device;
+  char time[6]; // "HH:MM" (UTC)
+} chat_entry_t;
+
+static SemaphoreHandle_t history_mutex = NULL;
+static char arena[CHAT_ARENA_SIZE];
+static int arena_used = 0;
+static chat_entry_t entries[CHAT_HISTORY_MAX_MESSAGES];
+static int entry_count = 0;
+static uint32_t first_seq = 0; // Sequence number of entries[0]
+static char latest_timestamp[CHAT_TIMESTAMP_MAX];
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+// Drop the oldest messages and slide the arena down over them
+static void evict(int count) {
+  int freed = 0;
+  for (int i = 0; i < count; i++) {
+    freed += entries[i].length;
+  }
+
+  memmove(arena, arena + freed, arena_used - freed);
+  arena_used -= freed;
+
+  memmove(entries, entries + count,
+          (entry_count - count) * sizeof(chat_entry_t));
+  entry_count -= count;
+  for (int i = 0; i < entry_count; i++) {
+    entries[i].offset -= freed;
+  }
+  first_seq += count;
+}
+
+// Length of text cut to at most max bytes without splitting a UTF-8
+// sequence
+static int clip_length(const char *text, int max) {
+  int len = strnlen(text, max + 1);
+  if (len <= max) {
+    return len;
+  }
+  len = max;
+  while (len > 0 && ((uint8_t)text[len] & 0xC0) == 0x80) {
+    len--;
+  }
+  return len;
+}
+
+// "YYYY-MM-DDTHH:MM..." -> "HH:MM"
+static void copy_time(char *dest, const char *timestamp) {
+  const char *t = strchr(timestamp, 'T');
+  if (t && strlen(t) >= 6) {
+    memcpy(dest, t + 1, 5);
+    dest[5] = '\0';
+  } else {
+    dest[0] = '\0';
+  }
+}
+
+// =============================================================================
+// Initialization
+// =============================================================================
+
+void chat_history_init(void) {
+  history_mutex = xSemaphoreCreateMutex();
+  chat_history_clear();
+}
+
+void chat_history_clear(void) {
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+  first_seq += entry_count;
+  entry_count = 0;
+  arena_used = 0;
+  latest_timestamp[0] = '\0';
+  xSemaphoreGive(history_mutex);
+}
+
+// =============================================================================
+// Adding Messages
+// =============================================================================
+
+bool chat_history_add(const char *content, const char *sender,
+                      const char *timestamp) {
+  if (!content) {
+    return false;
+  }
+  if (!timestamp) {
+    timestamp = "";
+  }
+
+  int len = clip_length(content, CHAT_MESSAGE_MAX - 1);
+
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+  // ISO 8601 timestamps in one format compare as strings
+  int order = 1;
+  if (entry_count > 0 && timestamp[0]) {
+    order = strncmp(timestamp, latest_timestamp, CHAT_TIMESTAMP_MAX - 1);
+  }
+  if (order <= 0) {
+    xSemaphoreGive(history_mutex);
+    if (order < 0) {
+      LOG_WARN(TAG, "Message from %s added out of order, ignored", timestamp);
+    }
+    return false;
+  }
+
+  // Evict until both an index slot and the text fit
+  int evicted = 0;
+  int needed = arena_used + len + 1;
+  while (evicted < entry_count &&
+         (entry_count - evicted >= CHAT_HISTORY_MAX_MESSAGES ||
+          needed > CHAT_ARENA_SIZE)) {
+    needed -= entries[evicted].length;
+    evicted++;
+  }
+  if (evicted > 0) {
+    evict(evicted);
+  }
+
+  chat_entry_t *entry = &entries[entry_count++];
+  entry->offset = arena_used;
+  entry->length = len + 1;
+  entry->from_device = sender && strcmp(sender, "DEVICE") == 0;
+  copy_time(entry->time, timestamp);
+
+  memcpy(&arena[arena_used], content, len);
+  arena[arena_used + len] = '\0';
+  arena_used += len + 1;
+
+  strncpy(latest_timestamp, timestamp, CHAT_TIMESTAMP_MAX - 1);
+  latest_timestamp[CHAT_TIMESTAMP_MAX - 1] = '\0';
+
+  xSemaphoreGive(history_mutex);
+  return true;
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+bool chat_history_get_range(uint32_t *first, uint32_t *end) {
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+  *first = first_seq;
+  *end = first_seq + entry_count;
+  bool any = entry_count > 0;
+  xSemaphoreGive(history_mutex);
+  return any;
+}
+
+bool chat_history_latest_timestamp(char *buffer, size_t len) {
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+  bool any = entry_count > 0 && latest_timestamp[0];
+  if (any) {
+    snprintf(buffer, len, "%s", latest_timestamp);
+  }
+  xSemaphoreGive(history_mutex);
+  return any;
+}
+
+// =============================================================================
+// Rendering
+// =============================================================================
+
+bool chat_history_render(uint32_t seq, int scroll, calx_text_size_t size) {
+  display_driver_clear();
+
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+  if (entry_count == 0) {
+    xSemaphoreGive(history_mutex);
+    const char *empty = "No messages";
+    int width = display_driver_get_text_width(empty, TEXT_SIZE_SMALL);
+    display_driver_draw_text((DISPLAY_WIDTH - width) / 2, 12, empty,
+                             TEXT_SIZE_SMALL);
+    return false;
+  }
+
+  int index = (seq < first_seq) ? 0 : (int)(seq - first_seq);
+  if (index >= entry_count) {
+    index = entry_count - 1;
+  }
+  const chat_entry_t *entry = &entries[index];
+
+  // Header: sender and time on the left, position on the right
+  char header[24];
+  snprintf(header, sizeof(header), "%s %s", entry->from_device ? "Me" : "Web",
+           entry->time);
+  display_driver_draw_text(1, 0, header, TEXT_SIZE_SMALL);
+  snprintf(header, sizeof(header), "%d/%d", index + 1, entry_count);
+  display_driver_draw_text(
+      DISPLAY_WIDTH - 1 -
+          display_driver_get_text_width(header, TEXT_SIZE_SMALL),
+      0, header, TEXT_SIZE_SMALL);
+  display_driver_invert_rect(0, 0, DISPLAY_WIDTH, CHAT_HEADER_HEIGHT);
+
+  // Wrap line by line, skipping to the scroll position and stopping one
+  // line past the screen
+  int line_height = display_driver_get_line_height(size);
+  int rows = (DISPLAY_HEIGHT - CHAT_HEADER_HEIGHT) / line_height;
+  const char *text = &arena[entry->offset];
+  bool more = false;
+
+  for (int line = 0; *text; line++) {
+    if (line >= scroll + rows) {
+      more = true;
+      break;
+    }
+
+    const char *next;
+    int len = text_renderer_line_break(text, DISPLAY_WIDTH, size, &next);
+    if (line >= scroll) {
+      display_driver_draw_text_len(
+          0, CHAT_HEADER_HEIGHT + (line - scroll) * line_height, text, len,
+          size);
+    }
+    text = next;
+  }
+
+  xSemaphoreGive(history_mutex);
+
+  if (more) {
+    display_driver_draw_text(122, DISPLAY_HEIGHT - 8, "v", TEXT_SIZE_SMALL);
+  }
+  if (scroll > 0) {
+    display_driver_draw_text(122, CHAT_HEADER_HEIGHT, "^", TEXT_SIZE_SMALL);
+  }
+  return more;
+}
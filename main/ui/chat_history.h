@@ -0,0 +1,70 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Chat History Header
+ * =============================================================================
+ * Cached chat messages for the chat screen. Message text is kept in one
+ * fixed arena with a small index entry per message; the oldest messages
+ * are evicted to make room, so memory use does not grow with the history.
+ * =============================================================================
+ */
+
+#ifndef CHAT_HISTORY_H
+#define CHAT_HISTORY_H
+
+#include "calx_config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHAT_HISTORY_MAX_MESSAGES 32
+#define CHAT_TIMESTAMP_MAX 25 // ISO 8601 with milliseconds, including NUL
+
+/**
+ * Initialize the chat history
+ */
+void chat_history_init(void);
+
+/**
+ * Drop all cached messages
+ */
+void chat_history_clear(void);
+
+/**
+ * Append a message, evicting the oldest ones if it does not fit
+ * Messages must be added oldest first: one not newer than the latest cached
+ * one is ignored (and logged), so fetches may overlap. Safe from any task.
+ * @param content Message text (UTF-8)
+ * @param sender "DEVICE" or "WEB"
+ * @param timestamp ISO 8601 creation time
+ * @return true if the message was added
+ */
+bool chat_history_add(const char *content, const char *sender,
+                      const char *timestamp);
+
+/**
+ * Get the sequence numbers of the cached messages
+ * Every message gets the next sequence number when added; eviction only
+ * moves the first one up.
+ * @param first Sequence number of the oldest message
+ * @param end Sequence number after the newest message
+ * @return false if the history is empty
+ */
+bool chat_history_get_range(uint32_t *first, uint32_t *end);
+
+/**
+ * Get the timestamp of the newest message, for fetching newer ones
+ * @return false if the history is empty
+ */
+bool chat_history_latest_timestamp(char *buffer, size_t len);
+
+/**
+ * Draw one message: a header line with sender, time and position, then the
+ * wrapped text from a given line. Only the lines on screen are wrapped.
+ * @param seq Message to draw, clamped to the cached range
+ * @param scroll First text line shown
+ * @param size Text size of the message text
+ * @return true if the text continues below the screen
+ */
+bool chat_history_render(uint32_t seq, int scroll, calx_text_size_t size);
+
+#endif // CHAT_HISTORY_H
@@ -0,0 +1,342 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Settings Menu
+ * =============================================================================
+ * Settings pages and the getters, setters and actions behind each entry.
+ * The UI manager renders and navigates every page the same way from this
+ * table.
+ * =============================================================================
+ */
+
+#include "esp_system.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "battery_manager.h"
+#include "chat_history.h"
+#include "logger.h"
+#include "ota_manager.h"
+#include "power_manager.h"
+#include "security_manager.h"
+#include "settings_menu.h"
+#include "storage_manager.h"
+#include "system_state.h"
+#include "ui_manager.h"
+#include "wifi_manager.h"
+
+static const char *TAG = "SETTINGS";
+
+// =============================================================================
+// Icons (8x8 bitmaps)
+// =============================================================================
+
+static const uint8_t icon_internet[] = {0x00, 0x18, 0x3C, 0x66, 0xC3,
+                                        0x81, 0x00, 0x18}; // WiFi signalish
+
+static const uint8_t icon_keyboard[] = {0xFF, 0x81, 0xBD, 0xA5,
+                                        0xA5, 0xBD, 0x81, 0xFF}; // Keypad
+
+static const uint8_t icon_display[] = {0x18, 0x42, 0x81, 0x81,
+                                       0x81, 0x81, 0x42, 0x18}; // Screen/Eye
+
+static const uint8_t icon_power[] = {0x18, 0x3C, 0x3C, 0x3C,
+                                     0x3C, 0x3C, 0x3C, 0x18}; // Battery
+
+static const uint8_t icon_device[] = {0x3C, 0x42, 0x81, 0x99,
+                                      0x99, 0x81, 0x42, 0x3C}; // Chip
+
+static const uint8_t icon_update[] = {0x18, 0x3C, 0x7E, 0x18,
+                                      0x18, 0x18, 0x00, 0x7E}; // Download arrow
+
+static const uint8_t icon_advanced[] = {0x3C, 0x42, 0x99, 0xBD,
+                                        0xBD, 0x99, 0x42, 0x3C}; // Gear
+
+// =============================================================================
+// Getters and Setters
+// =============================================================================
+
+static int get_keyboard(void) { return storage_manager_get_keyboard(); }
+
+static void set_keyboard(int value) {
+  storage_manager_set_keyboard((calx_keyboard_t)value);
+}
+
+static int get_text_size(void) { return storage_manager_get_text_size(); }
+
+static void set_text_size(int value) {
+  storage_manager_set_text_size((calx_text_size_t)value);
+}
+
+static int get_power_mode(void) { return power_manager_get_mode(); }
+
+static void set_power_mode(int value) {
+  power_manager_set_mode((calx_power_mode_t)value);
+}
+
+static int get_screen_timeout(void) {
+  return power_manager_get_screen_timeout();
+}
+
+static void set_screen_timeout(int value) {
+  power_manager_set_screen_timeout(value);
+}
+
+// =============================================================================
+// Read-only Values
+// =============================================================================
+
+static void format_wifi_status(char *buffer, size_t len) {
+  snprintf(buffer, len, "%s",
+           wifi_manager_is_connected() ? "Online" : "Offline");
+}
+
+static void format_wifi_network(char *buffer, size_t len) {
+  const char *ssid = wifi_manager_get_ssid();
+  snprintf(buffer, len, "%s", (ssid && ssid[0]) ? ssid : "None");
+}
+
+static void format_wifi_ip(char *buffer, size_t len) {
+  const char *ip = wifi_manager_get_ip();
+  snprintf(buffer, len, "%s",
+           (wifi_manager_is_connected() && ip && ip[0]) ? ip : "-");
+}
+
+static void format_wifi_signal(char *buffer, size_t len) {
+  if (wifi_manager_is_connected()) {
+    snprintf(buffer, len, "%d dBm", wifi_manager_get_rssi());
+  } else {
+    snprintf(buffer, len, "-");
+  }
+}
+
+static void format_battery(char *buffer, size_t len) {
+  snprintf(buffer, len, "%d%%", battery_manager_get_percent());
+}
+
+static void format_voltage(char *buffer, size_t len) {
+  snprintf(buffer, len, "%d mV", battery_manager_get_voltage_mv());
+}
+
+static void format_charging(char *buffer, size_t len) {
+  snprintf(buffer, len, "%s", battery_manager_is_charging() ? "Yes" : "No");
+}
+
+static void format_device_id(char *buffer, size_t len) {
+  char id[40];
+  if (!security_manager_get_device_id(id, sizeof(id))) {
+    snprintf(id, sizeof(id), "-");
+  }
+  snprintf(buffer, len, "%s", id);
+}
+
+static void format_bound(char *buffer, size_t len) {
+  snprintf(buffer, len, "%s", security_manager_is_bound() ? "Yes" : "No");
+}
+
+static void format_version(char *buffer, size_t len) {
+  snprintf(buffer, len, "v%s", CALX_FW_VERSION);
+}
+
+static void format_available(char *buffer, size_t len) {
+  const char *version = ota_manager_get_available_version();
+  if (version) {
+    snprintf(buffer, len, "v%s", version);
+  } else {
+    snprintf(buffer, len, "None");
+  }
+}
+
+// =============================================================================
+// Actions
+// =============================================================================
+
+static void action_wifi_setup(void) {
+  wifi_manager_start_ap();
+  system_state_set(STATE_WIFI_SETUP);
+}
+
+static void action_unbind(void) {
+  security_manager_unbind();
+  // Messages and the fetch cursor belong to the account just unbound
+  chat_history_clear();
+  system_state_set(STATE_NOT_BOUND);
+}
+
+static void action_factory_reset(void) {
+  storage_manager_factory_reset();
+  esp_restart();
+}
+
+static void action_reboot(void) {
+  LOG_INFO(TAG, "Reboot requested from settings");
+  esp_restart();
+}
+
+// =============================================================================
+// Schema
+// =============================================================================
+
+#define INFO(name, fn) {.label = name, .type = SETTING_INFO, .format = fn}
+#define ACTION(name, fn, needs_confirm)                                        \
+  {.label = name,                                                              \
+   .type = SETTING_ACTION,                                                     \
+   .action = fn,                                                               \
+   .confirm = needs_confirm}
+
+static const char *const keyboard_names[] = {"QWERTY", "T9"};
+static const char *const text_size_names[] = {"Small", "Normal", "Large"};
+static const char *const power_mode_names[] = {"Normal", "Low"};
+
+static const setting_t internet_items[] = {
+    INFO("Status", format_wifi_status),
+    INFO("Network", format_wifi_network),
+    INFO("IP", format_wifi_ip),
+    INFO("Signal", format_wifi_signal),
+    ACTION("WiFi Setup", action_wifi_setup, false),
+};
+
+static const setting_t keyboard_items[] = {
+    {.label = "Mode",
+     .type = SETTING_CHOICE,
+     .get = get_keyboard,
+     .set = set_keyboard,
+     .min = KEYBOARD_QWERTY,
+     .max = KEYBOARD_T9,
+     .step = 1,
+     .choices = keyboard_names},
+};
+
+static const setting_t display_items[] = {
+    {.label = "Text Size",
+     .type = SETTING_CHOICE,
+     .get = get_text_size,
+     .set = set_text_size,
+     .min = TEXT_SIZE_SMALL,
+     .max = TEXT_SIZE_LARGE,
+     .step = 1,
+     .choices = text_size_names},
+    {.label = "Timeout",
+     .type = SETTING_NUMBER,
+     .get = get_screen_timeout,
+     .set = set_screen_timeout,
+     .min = SCREEN_TIMEOUT_MIN_S,
+     .max = SCREEN_TIMEOUT_MAX_S,
+     .step = 10,
+     .unit = "s"},
+};
+
+static const setting_t power_items[] = {
+    {.label = "Power Mode",
+     .type = SETTING_CHOICE,
+     .get = get_power_mode,
+     .set = set_power_mode,
+     .min = POWER_MODE_NORMAL,
+     .max = POWER_MODE_LOW,
+     .step = 1,
+     .choices = power_mode_names},
+    INFO("Battery", format_battery),
+    INFO("Voltage", format_voltage),
+    INFO("Charging", format_charging),
+};
+
+static const setting_t device_items[] = {
+    INFO("ID", format_device_id),
+    INFO("Bound", format_bound),
+    ACTION("Unbind", action_unbind, true),
+};
+
+static const setting_t update_items[] = {
+    INFO("Version", format_version),
+    INFO("Available", format_available),
+};
+
+static const setting_t advanced_items[] = {
+    ACTION("Factory Reset", action_factory_reset, true),
+    ACTION("Clear Cache", storage_manager_clear_cache, false),
+    ACTION("Debug Info", ui_manager_show_debug_info, false),
+    ACTION("Reboot", action_reboot, true),
+};
+
+#define PAGE(name, bitmap, entries)                                            \
+  {.title = name,                                                              \
+   .icon = bitmap,                                                             \
+   .items = entries,                                                           \
+   .count = (int)(sizeof(entries) / sizeof((entries)[0]))}
+
+static const settings_page_t pages[] = {
+    PAGE("Internet", icon_internet, internet_items),
+    PAGE("Keyboard", icon_keyboard, keyboard_items),
+    PAGE("Display", icon_display, display_items),
+    PAGE("Power", icon_power, power_items),
+    PAGE("Device", icon_device, device_items),
+    PAGE("Update", icon_update, update_items),
+    PAGE("Advanced", icon_advanced, advanced_items),
+};
+
+#define PAGE_COUNT ((int)(sizeof(pages) / sizeof(pages[0])))
+
+// =============================================================================
+// Access
+// =============================================================================
+
+int settings_menu_page_count(void) { return PAGE_COUNT; }
+
+const settings_page_t *settings_menu_page(int index) {
+  if (index < 0 || index >= PAGE_COUNT) {
+    return NULL;
+  }
+  return &pages[index];
+}
+
+void settings_menu_format_value(const setting_t *setting, bool confirming,
+                                char *buffer, size_t len) {
+  switch (setting->type) {
+  case SETTING_INFO:
+    setting->format(buffer, len);
+    break;
+  case SETTING_CHOICE: {
+    int value = setting->get();
+    if (value < setting->min || value > setting->max) {
+      snprintf(buffer, len, "?");
+    } else {
+      snprintf(buffer, len, "%s", setting->choices[value - setting->min]);
+    }
+    break;
+  }
+  case SETTING_NUMBER:
+    snprintf(buffer, len, "%d%s", setting->get(),
+             setting->unit ? setting->unit : "");
+    break;
+  case SETTING_ACTION:
+    snprintf(buffer, len, "%s", confirming ? "Confirm?" : "Select");
+    break;
+  }
+}
+
+void settings_menu_step(const setting_t *setting, int direction) {
+  if ((setting->type != SETTING_CHOICE && setting->type != SETTING_NUMBER) ||
+      !setting->set) {
+    return;
+  }
+
+  int step = setting->step > 0 ? setting->step : 1;
+  int top = setting->min + ((setting->max - setting->min) / step) * step;
+  int value = setting->get();
+
+  if (value < setting->min || value > setting->max) {
+    // Stored value is outside the range; land on the end moved towards
+    value = (direction > 0) ? setting->min : top;
+  } else {
+    int snapped = setting->min + ((value - setting->min) / step) * step;
+    if (direction > 0) {
+      value = (snapped + step > top) ? setting->min : snapped + step;
+    } else if (snapped != value) {
+      value = snapped; // Off-step value: the previous step is below it
+    } else {
+      value = (value - step < setting->min) ? top : value - step;
+    }
+  }
+
+  setting->set(value);
+  LOG_INFO(TAG, "%s set to %d", setting->label, value);
+}
@@ -0,0 +1,88 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Settings Menu Header
+ * =============================================================================
+ * Declarative settings schema. Every page and entry is const and lives in
+ * flash; values are read from and written to their owning module on
+ * demand, so the menus always show the real settings and adding one costs
+ * no RAM.
+ * =============================================================================
+ */
+
+#ifndef SETTINGS_MENU_H
+#define SETTINGS_MENU_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SETTINGS_MAX_PAGES 9      // Reachable with keys 1-9
+#define SETTINGS_PAGE_MAX_ITEMS 8 // Entries per page
+#define SETTING_VALUE_MAX 24      // Formatted value, including NUL
+
+typedef enum {
+  SETTING_INFO,   // Read-only, text from format()
+  SETTING_CHOICE, // One of choices[], stored as min..max
+  SETTING_NUMBER, // min..max in steps of step, shown with unit
+  SETTING_ACTION  // Runs action() when selected
+} setting_type_t;
+
+/**
+ * One settings entry
+ * CHOICE and NUMBER entries go through get()/set(); set() may be NULL for
+ * a value that can only be viewed.
+ */
+typedef struct {
+  const char *label;
+  setting_type_t type;
+  int (*get)(void);
+  void (*set)(int value);
+  int min, max, step;
+  const char *const *choices;               // CHOICE: names of min..max
+  const char *unit;                         // NUMBER: suffix, may be NULL
+  void (*format)(char *buffer, size_t len); // INFO
+  void (*action)(void);                     // ACTION
+  bool confirm;                             // ACTION: select twice to run
+} setting_t;
+
+/**
+ * A settings submenu
+ */
+typedef struct {
+  const char *title;
+  const uint8_t *icon; // 8x8 bitmap
+  const setting_t *items;
+  int count;
+} settings_page_t;
+
+/**
+ * Get the number of settings pages
+ */
+int settings_menu_page_count(void);
+
+/**
+ * Get a settings page
+ * @param index Page index, 0 to settings_menu_page_count() - 1
+ */
+const settings_page_t *settings_menu_page(int index);
+
+/**
+ * Format the current value of an entry
+ * Actions show "Select", or "Confirm?" while awaiting confirmation.
+ * @param setting Entry to format
+ * @param confirming The entry was selected once and needs confirmation
+ * @param buffer Output buffer
+ * @param len Buffer size
+ */
+void settings_menu_format_value(const setting_t *setting, bool confirming,
+                                char *buffer, size_t len);
+
+/**
+ * Step a CHOICE or NUMBER entry to its next or previous value
+ * Wraps around at either end of the range and stores the new value.
+ * @param setting Entry to change
+ * @param direction +1 for the next value, -1 for the previous one
+ */
+void settings_menu_step(const setting_t *setting, int direction);
+
+#endif // SETTINGS_MENU_H
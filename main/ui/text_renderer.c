@@ -3,64 +3,101 @@
  * CalX ESP32 Firmware - Text Renderer
  * =============================================================================
  * Word wrapping, pagination, and text rendering for OLED display.
+ *
+ * Content is the caller's text, wrapped lazily in place: line breaks are
+ * found only when a line is needed, and the start of every
+ * CHECKPOINT_LINES-th line is remembered on the way so later seeks scan at
+ * most that many lines. Lines are drawn straight from the source as
+ * (start, length) spans, so content is never copied.
+ *
+ * A line index is only valid for one text at one size. The last few are
+ * kept in a small LRU keyed by the text's address, length and generation
+ * (which the caller changes whenever the text at an address changes) and
+ * the size, so going back to a screen or text size reuses the breaks found
+ * before instead of wrapping again, without reading the text to tell.
  * =============================================================================
  */
 
 #include "text_renderer.h"
 #include "calx_config.h"
 #include "display_driver.h"
-#include <ctype.h>
+#include "utf8.h"
+#include <limits.h>
 #include <string.h>
 
 // =============================================================================
 // Configuration
 // =============================================================================
-#define MAX_CONTENT_SIZE 4096
-#define MAX_LINES 100
-#define MAX_LINE_LENGTH 32
+#define CHECKPOINT_LINES 8
+#define MAX_CHECKPOINTS 256 // Past line 2048 seeks scan from the last one
+#define LAYOUT_SLOTS 4      // Cached (text, size) line indexes
+
+// Scroll indicators, drawn over the right edge of the first and last rows
+#define INDICATOR_X 122
+#define INDICATOR_HEIGHT 8
+#define UP_Y 0
+#define DOWN_Y (DISPLAY_HEIGHT - INDICATOR_HEIGHT)
 
 // =============================================================================
 // State
 // =============================================================================
-static char content_buffer[MAX_CONTENT_SIZE];
-static char *line_starts[MAX_LINES];
-static int line_lengths[MAX_LINES];
-static int total_lines = 0;
+
+// Line index of one text at one size
+typedef struct {
+  const char *text;
+  uint32_t length;
+  uint32_t generation;
+  calx_text_size_t size;
+  int checkpoint_count; // Checkpoint 0 is the start; 0 if the slot is free
+  int total_lines;      // -1 until the end has been reached
+  uint32_t last_used;
+  uint16_t checkpoints[MAX_CHECKPOINTS]; // Offset of line i * CP_LINES
+} layout_t;
+
+static layout_t layouts[LAYOUT_SLOTS];
+static layout_t *layout = &layouts[0];
+static uint32_t use_clock = 0;
+
+static const char *content = "";
+static uint32_t content_length = 0;
+static uint32_t content_generation = 0;
 static calx_text_size_t current_size = TEXT_SIZE_NORMAL;
+static int rendered_scroll = -1; // Scroll line in the frame buffer, -1 if none
+static bool rendered_more = false; // Down indicator drawn with that render
+static int highlight_start = -1; // Inverted byte range, -1 if none
+static int highlight_end = -1;
 
 // =============================================================================
 // Initialization
 // =============================================================================
 
+static void select_layout(void);
+
 void text_renderer_init(void) {
-  memset(content_buffer, 0, sizeof(content_buffer));
-  memset(line_starts, 0, sizeof(line_starts));
-  total_lines = 0;
+  memset(layouts, 0, sizeof(layouts));
+  use_clock = 0;
+  content = "";
+  content_length = 0;
+  content_generation = 0;
+  rendered_scroll = -1;
+  highlight_start = highlight_end = -1;
+  select_layout();
 }
 
+void text_renderer_invalidate(void) { rendered_scroll = -1; }
+
 // =============================================================================
-// Get Characters Per Line
+// Lines Per Screen
 // =============================================================================
 
-static int get_chars_per_line(calx_text_size_t size) {
-  switch (size) {
-  case TEXT_SIZE_SMALL:
-    return TEXT_SMALL_CHARS_LINE;
-  case TEXT_SIZE_NORMAL:
-    return TEXT_NORMAL_CHARS_LINE;
-  case TEXT_SIZE_LARGE:
-    return TEXT_LARGE_CHARS_LINE;
-  default:
-    return TEXT_NORMAL_CHARS_LINE;
-  }
-}
-
 static int get_lines_per_screen(calx_text_size_t size) {
   switch (size) {
   case TEXT_SIZE_SMALL:
     return TEXT_SMALL_LINES;
   case TEXT_SIZE_NORMAL:
     return TEXT_NORMAL_LINES;
+  case TEXT_SIZE_MEDIUM:
+    return TEXT_MEDIUM_LINES;
   case TEXT_SIZE_LARGE:
     return TEXT_LARGE_LINES;
   default:
@@ -72,120 +109,296 @@ static int get_lines_per_screen(calx_text_size_t size) {
 // Word Wrapping
 // =============================================================================
 
-void text_renderer_wrap(const char *input, char *output, int max_output_len,
-                        int chars_per_line) {
-  int in_pos = 0;
-  int out_pos = 0;
-  int line_pos = 0;
-  int last_space = -1;
-  int last_space_out = -1;
-
-  while (input[in_pos] && out_pos < max_output_len - 1) {
-    char c = input[in_pos];
-
-    // Handle newlines in input
-    if (c == '\n') {
-      output[out_pos++] = '\n';
-      line_pos = 0;
-      last_space = -1;
-      in_pos++;
-      continue;
+int text_renderer_line_break(const char *text, int max_width,
+                             calx_text_size_t size, const char **next) {
+  const char *p = text;
+  const char *last_space = NULL;
+  int line_width = 0;
+
+  while (*p && *p != '\n') {
+    const char *after = p;
+    int advance = display_driver_get_glyph_advance(utf8_next(&after), size);
+
+    if (line_width > 0 && line_width + advance > max_width) {
+      if (*p == ' ') {
+        *next = p + 1; // Break at this space
+      } else if (last_space) {
+        *next = last_space + 1; // Break at the last space
+        p = last_space;
+      } else {
+        *next = p; // Hard wrap
+      }
+      return p - text;
     }
 
-    // Track last space for word wrapping
-    if (c == ' ') {
-      last_space = in_pos;
-      last_space_out = out_pos;
+    if (*p == ' ' && p > text) {
+      last_space = p; // A leading space would leave an empty line
     }
+    line_width += advance;
+    p = after;
+  }
 
-    // Check if we need to wrap
-    if (line_pos >= chars_per_line) {
-      // Try to wrap at last space
-      if (last_space > 0 && last_space_out > 0) {
-        // Replace space with newline
-        output[last_space_out] = '\n';
-        line_pos = out_pos - last_space_out - 1;
-      } else {
-        // Hard wrap
-        output[out_pos++] = '\n';
-        line_pos = 0;
-      }
-      last_space = -1;
-      last_space_out = -1;
+  *next = (*p == '\n') ? p + 1 : p;
+  return p - text;
+}
+
+// =============================================================================
+// Line Index
+// =============================================================================
+
+// Make the layout of the current text and size current, reusing a cached
+// one or recycling the least recently used slot
+static void select_layout(void) {
+  layout_t *victim = &layouts[0];
+
+  for (int i = 0; i < LAYOUT_SLOTS; i++) {
+    layout_t *l = &layouts[i];
+    if (l->checkpoint_count > 0 && l->text == content &&
+        l->length == content_length && l->generation == content_generation &&
+        l->size == current_size) {
+      layout = l;
+      layout->last_used = ++use_clock;
+      return;
     }
+    if (victim->checkpoint_count > 0 &&
+        (l->checkpoint_count == 0 || l->last_used < victim->last_used)) {
+      victim = l;
+    }
+  }
+
+  layout = victim;
+  layout->text = content;
+  layout->length = content_length;
+  layout->generation = content_generation;
+  layout->size = current_size;
+  layout->checkpoints[0] = 0;
+  layout->checkpoint_count = 1;
+  layout->total_lines = content_length ? -1 : 0;
+  layout->last_used = ++use_clock;
+}
 
-    output[out_pos++] = c;
-    line_pos++;
-    in_pos++;
+// Start of the line after line n, which starts at p. Records it if it is
+// the next checkpoint.
+static const char *next_line(const char *p, int n) {
+  text_renderer_line_break(p, DISPLAY_WIDTH, current_size, &p);
+  n++;
+  if (n == layout->checkpoint_count * CHECKPOINT_LINES &&
+      layout->checkpoint_count < MAX_CHECKPOINTS &&
+      p - content <= UINT16_MAX) {
+    layout->checkpoints[layout->checkpoint_count++] = p - content;
   }
+  return p;
+}
 
-  output[out_pos] = '\0';
+// Start of the given wrapped line, or NULL past the last line. Scans from
+// the nearest checkpoint at or before it, adding checkpoints as it goes.
+static const char *seek_line(int line) {
+  int cp = line / CHECKPOINT_LINES;
+  if (cp >= layout->checkpoint_count) {
+    cp = layout->checkpoint_count - 1;
+  }
+
+  const char *p = &content[layout->checkpoints[cp]];
+  int n = cp * CHECKPOINT_LINES;
+
+  while (n < line && *p) {
+    p = next_line(p, n);
+    n++;
+  }
+
+  if (!*p) {
+    layout->total_lines = n; // Ran into the end
+    return NULL;
+  }
+  return p;
 }
 
 // =============================================================================
-// Set Content
+// Search
 // =============================================================================
 
-void text_renderer_set_content(const char *content, calx_text_size_t size) {
-  current_size = size;
+static inline uint8_t fold_case(uint8_t c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
 
-  // Word wrap the content
-  int chars_per_line = get_chars_per_line(size);
-  text_renderer_wrap(content, content_buffer, MAX_CONTENT_SIZE, chars_per_line);
+int text_renderer_find_all(const char *pattern, uint16_t *offsets,
+                           int max_offsets) {
+  int m = strlen(pattern);
+  int n = content_length;
+  if (m == 0 || m > n) {
+    return 0;
+  }
+  if (n > UINT16_MAX + 1) {
+    n = UINT16_MAX + 1; // Offsets past that can't be returned
+  }
 
-  // Parse into lines
-  total_lines = 0;
-  char *line_start = content_buffer;
+  // Boyer-Moore-Horspool: on a mismatch, shift by how far the text byte
+  // under the pattern's last position is from the pattern's end
+  uint8_t shift[256];
+  int max_shift = m < 255 ? m : 255;
+  memset(shift, max_shift, sizeof(shift));
+  for (int i = 0; i < m - 1; i++) {
+    int d = m - 1 - i;
+    shift[fold_case(pattern[i])] = d < 255 ? d : 255;
+  }
 
-  for (int i = 0; content_buffer[i] && total_lines < MAX_LINES; i++) {
-    if (content_buffer[i] == '\n' || content_buffer[i + 1] == '\0') {
-      line_starts[total_lines] = line_start;
+  const uint8_t *text = (const uint8_t *)content;
+  int count = 0;
+  int i = 0;
+  while (i <= n - m && count < max_offsets) {
+    int j = m - 1;
+    while (j >= 0 && fold_case(text[i + j]) == fold_case(pattern[j])) {
+      j--;
+    }
+    if (j < 0) {
+      offsets[count++] = i;
+      i += m; // Matches don't overlap
+    } else {
+      i += shift[fold_case(text[i + m - 1])];
+    }
+  }
+  return count;
+}
 
-      if (content_buffer[i] == '\n') {
-        line_lengths[total_lines] = &content_buffer[i] - line_start;
-        content_buffer[i] = '\0'; // Null-terminate line
-      } else {
-        line_lengths[total_lines] = &content_buffer[i + 1] - line_start;
-      }
+void text_renderer_set_highlight(int offset, int length) {
+  int end = (offset >= 0) ? offset + length : -1;
+  if (offset == highlight_start && end == highlight_end) {
+    return;
+  }
+  highlight_start = offset;
+  highlight_end = end;
+  rendered_scroll = -1; // Lines still on screen may carry the old one
+}
 
-      total_lines++;
-      line_start = &content_buffer[i + 1];
-    }
+// =============================================================================
+// Set Content
+// =============================================================================
+
+void text_renderer_set_content(const char *text, size_t length,
+                               uint32_t generation, calx_text_size_t size) {
+  content = text ? text : "";
+  content_length = text ? length : 0;
+  content_generation = generation;
+  current_size = size;
+  rendered_scroll = -1;
+
+  // Nothing is read or wrapped until drawn
+  select_layout();
+}
+
+void text_renderer_set_size(calx_text_size_t size) {
+  if (size == current_size) {
+    return;
   }
+  current_size = size;
+  rendered_scroll = -1;
+  select_layout();
 }
 
 // =============================================================================
 // Render Content
 // =============================================================================
 
+// Width in pixels of the text from start up to end
+static int span_width(const char *start, const char *end) {
+  int width = 0;
+  while (start < end && *start) {
+    width += display_driver_get_glyph_advance(utf8_next(&start), current_size);
+  }
+  return width;
+}
+
+static void draw_line(int row, const char *text, int len, int line_height) {
+  display_driver_draw_text_len(0, row * line_height, text, len, current_size);
+
+  // Invert the part of the highlight on this line
+  int start = text - content;
+  int from = highlight_start > start ? highlight_start : start;
+  int to = highlight_end < start + len ? highlight_end : start + len;
+  if (from < to) {
+    int x = span_width(text, &content[from]);
+    display_driver_invert_rect(x, row * line_height,
+                               span_width(&content[from], &content[to]),
+                               line_height);
+  }
+}
+
+// Whether text line row overlaps an indicator drawn at row top
+static bool line_overlaps(int row, int line_height, int top) {
+  return row * line_height < top + INDICATOR_HEIGHT &&
+         top < (row + 1) * line_height;
+}
+
 void text_renderer_render_content(int scroll_line) {
   if (scroll_line < 0)
     scroll_line = 0;
-  if (scroll_line >= total_lines)
-    scroll_line = total_lines > 0 ? total_lines - 1 : 0;
+
+  const char *text = seek_line(scroll_line);
+  if (!text && scroll_line > 0) {
+    // Past the end: show the last line at the top
+    scroll_line = layout->total_lines > 0 ? layout->total_lines - 1 : 0;
+    text = seek_line(scroll_line);
+  }
 
   int lines_per_screen = get_lines_per_screen(current_size);
   int line_height = display_driver_get_line_height(current_size);
+  int delta = scroll_line - rendered_scroll;
+  int shift_rows = delta * line_height;
+  int text_rows = lines_per_screen * line_height;
+
+  // Lines that stay visible are shifted by the display scroll engine, so
+  // only the exposed lines are drawn (and sent), along with any line a
+  // shifted scroll indicator landed on.
+  bool shift = rendered_scroll >= 0 && delta != 0 &&
+               delta > -lines_per_screen && delta < lines_per_screen;
+  if (shift) {
+    display_driver_scroll(shift_rows);
+    if (text_rows < DISPLAY_HEIGHT) {
+      // Clear what moved into the rows below the last line
+      display_driver_fill_rect(0, text_rows, DISPLAY_WIDTH,
+                               DISPLAY_HEIGHT - text_rows, false);
+    }
+  } else {
+    display_driver_clear();
+  }
 
-  display_driver_clear();
-
-  for (int i = 0; i < lines_per_screen && (scroll_line + i) < total_lines;
-       i++) {
-    int line_idx = scroll_line + i;
-    if (line_starts[line_idx]) {
-      display_driver_draw_text(0, i * line_height, line_starts[line_idx],
-                               current_size);
+  // Wrap only the lines on screen
+  const char *p = text ? text : "";
+  for (int i = 0; i < lines_per_screen; i++) {
+    const char *next = p;
+    int len = *p ? text_renderer_line_break(p, DISPLAY_WIDTH, current_size,
+                                            &next)
+                 : 0;
+
+    bool redraw = !shift;
+    if (shift) {
+      redraw = (delta > 0) ? (i >= lines_per_screen - delta) : (i < -delta);
+      redraw = redraw || (rendered_scroll > 0 &&
+                          line_overlaps(i, line_height, UP_Y - shift_rows));
+      redraw = redraw || (rendered_more &&
+                          line_overlaps(i, line_height, DOWN_Y - shift_rows));
+      if (redraw) {
+        display_driver_fill_rect(0, i * line_height, DISPLAY_WIDTH,
+                                 line_height, false);
+      }
+    }
+    if (redraw && *p) {
+      draw_line(i, p, len, line_height);
     }
+    p = next;
   }
 
+  rendered_scroll = scroll_line;
+  rendered_more = *p != '\0';
+
   // Show scroll indicator if there's more content
-  if (scroll_line + lines_per_screen < total_lines) {
+  if (rendered_more) {
     // Draw down arrow indicator
-    display_driver_draw_text(122, 24, "v", TEXT_SIZE_SMALL);
+    display_driver_draw_text(INDICATOR_X, DOWN_Y, "v", TEXT_SIZE_SMALL);
   }
   if (scroll_line > 0) {
     // Draw up arrow indicator
-    display_driver_draw_text(122, 0, "^", TEXT_SIZE_SMALL);
+    display_driver_draw_text(INDICATOR_X, UP_Y, "^", TEXT_SIZE_SMALL);
   }
 }
 
@@ -193,10 +406,48 @@ void text_renderer_render_content(int scroll_line) {
 // Queries
 // =============================================================================
 
-int text_renderer_get_line_count(void) { return total_lines; }
+int text_renderer_line_at(int offset) {
+  if (offset < 0) {
+    offset = 0;
+  }
+
+  // Last checkpoint at or before the offset
+  int lo = 0;
+  int hi = layout->checkpoint_count - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (layout->checkpoints[mid] <= offset) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  const char *target = &content[offset];
+  const char *p = &content[layout->checkpoints[lo]];
+  int n = lo * CHECKPOINT_LINES;
+
+  while (*p) {
+    const char *next = next_line(p, n);
+    if (target < next || !*next) {
+      break;
+    }
+    p = next;
+    n++;
+  }
+  return n;
+}
+
+int text_renderer_get_line_count(void) {
+  if (layout->total_lines < 0) {
+    seek_line(INT_MAX); // Runs into the end and records it
+  }
+  return layout->total_lines;
+}
 
 int text_renderer_get_page_count(int lines_per_page) {
   if (lines_per_page <= 0)
     return 1;
-  return (total_lines + lines_per_page - 1) / lines_per_page;
+  return (text_renderer_get_line_count() + lines_per_page - 1) /
+         lines_per_page;
 }
@@ -8,6 +8,8 @@
 #define TEXT_RENDERER_H
 
 #include "calx_config.h"
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * Initialize text renderer
@@ -16,23 +18,71 @@ void text_renderer_init(void);
 
 /**
  * Set content for rendering
+ * The text is referenced, not copied: it must stay valid and unchanged
+ * until the next call. Line breaks found for a text are cached per size,
+ * so setting a recently shown text again does not rewrap it.
  * @param content Text content
+ * @param length strlen(content)
+ * @param generation Must differ from that of any earlier text at the same
+ *                   address and length, since it is what tells them apart
  * @param size Text size to use
  */
-void text_renderer_set_content(const char *content, calx_text_size_t size);
+void text_renderer_set_content(const char *content, size_t length,
+                               uint32_t generation, calx_text_size_t size);
+
+/**
+ * Change the text size of the current content
+ * Reuses the line breaks of an earlier layout at that size if cached.
+ * @param size Text size to use
+ */
+void text_renderer_set_size(calx_text_size_t size);
 
 /**
  * Render content to display at given scroll offset
+ * When the frame buffer still holds the previous render of this content,
+ * it is scrolled in place at any line size and only the exposed lines are
+ * redrawn.
  * @param scroll_line Starting line (for scrolling)
  */
 void text_renderer_render_content(int scroll_line);
 
+/**
+ * Forget the previous render, e.g. after another screen used the frame
+ * buffer. The next render draws every line.
+ */
+void text_renderer_invalidate(void);
+
 /**
  * Get total number of lines for current content
  * @return Number of wrapped lines
  */
 int text_renderer_get_line_count(void);
 
+/**
+ * Get the wrapped line that holds a byte of the current content
+ * @param offset Byte offset into the content
+ * @return Line number, the last line for offsets past the end
+ */
+int text_renderer_line_at(int offset);
+
+/**
+ * Find every occurrence of a pattern in the current content
+ * Case-insensitive for ASCII letters; matches don't overlap.
+ * @param pattern Text to find
+ * @param offsets Output byte offsets of the matches, in order
+ * @param max_offsets Size of offsets; the search stops when it is full
+ * @return Number of matches stored
+ */
+int text_renderer_find_all(const char *pattern, uint16_t *offsets,
+                           int max_offsets);
+
+/**
+ * Draw a byte range of the content inverted, e.g. a search match
+ * @param offset First byte, or -1 for no highlight
+ * @param length Bytes in the range
+ */
+void text_renderer_set_highlight(int offset, int length);
+
 /**
  * Get number of pages for current content
  * @param lines_per_page Lines visible per page
@@ -41,13 +91,17 @@ int text_renderer_get_line_count(void);
 int text_renderer_get_page_count(int lines_per_page);
 
 /**
- * Word-wrap text to fit display width
- * @param input Input text
- * @param output Output buffer
- * @param max_output_len Maximum output length
- * @param chars_per_line Characters per line
+ * Find the first wrapped line of a text
+ * Breaks after the last space that fits (or mid-word if there is none) and
+ * at newlines, so a text can be wrapped a line at a time in place.
+ * @param text NUL-terminated text
+ * @param max_width Line width in pixels
+ * @param size Text size used to measure glyphs
+ * @param next Set to the start of the following line (at the NUL when the
+ *             text ends)
+ * @return Length of the line in bytes, without the break
  */
-void text_renderer_wrap(const char *input, char *output, int max_output_len,
-                        int chars_per_line);
+int text_renderer_line_break(const char *text, int max_width,
+                             calx_text_size_t size, const char **next);
 
 #endif // TEXT_RENDERER_H
@@ -9,17 +9,24 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 #include <stdio.h>
 #include <string.h>
 
+#include "animation.h"
 #include "api_client.h"
 #include "battery_manager.h"
+#include "chat_history.h"
 #include "display_driver.h"
 #include "logger.h"
 #include "power_manager.h"
+#include "settings_menu.h"
+#include "storage_manager.h"
 #include "system_state.h"
 #include "text_renderer.h"
 #include "ui_manager.h"
+#include "ui_metrics.h"
+#include "widget.h"
 #include "wifi_manager.h"
 
 static const char *TAG = "UI";
@@ -29,6 +36,8 @@ static const char *TAG = "UI";
 // =============================================================================
 static SemaphoreHandle_t ui_mutex = NULL;
 static bool needs_redraw = true;
+static TaskHandle_t ui_task_handle = NULL; // Woken by request_redraw()
+static TickType_t last_frame_tick = 0;
 static calx_state_t current_screen = STATE_BOOT;
 
 // Screen-specific state
@@ -36,6 +45,7 @@ static int menu_selection = 0;
 static int settings_selection = 0;
 static bool in_settings_submenu = false; // Are we in a submenu?
 static int submenu_selection = 0;        // Which option in submenu
+static int submenu_confirm = -1; // Action waiting for a second select
 static bool has_notification = false;
 
 // Content buffers
@@ -44,16 +54,242 @@ static char error_message[32] = "Error";
 static char bind_code[5] = "----";
 static int ota_progress = 0;
 
-// Chat state
+// Animations; all of them stop when the screen changes
+#define SPINNER_PERIOD_MS 800 // One turn of the busy spinner
+#define OTA_GLIDE_MS 300      // Progress bar catching up with a new percent
+static animation_t spinner_anim;
+static animation_t ota_anim;
+static int ota_target = -1; // Percent ota_anim runs to, -1 before the first
+
+// Menu <-> screen slide: the new screen is rendered whole each frame and
+// pushes the last frame of the old one out sideways
+#define SLIDE_MS 200
+static animation_t slide_anim; // Columns of the new screen shown
+static uint8_t slide_from[DISPLAY_BUFFER_SIZE];
+static bool slide_from_left = false; // Back to the menu
+static bool sliding = false;
+
+// Chat state: the message shown (a chat history sequence number) and the
+// first of its lines on screen
+static uint32_t chat_message = 0;
+static bool chat_follow = true; // Show the newest message as they arrive
 static int chat_scroll = 0;
-static int chat_page = 0;
+static bool chat_more_below = false;
+
+// Texts of the file and AI screens. Each new text gets the next generation,
+// which keys the renderer's layout cache along with its address and length;
+// the one in the text renderer is shown_generation.
+typedef struct {
+  const char *text;
+  size_t length;
+  uint32_t generation;
+} screen_text_t;
+
+static screen_text_t file_text = {.text = ""};
+static screen_text_t ai_text = {.text = ""};
+static uint32_t text_generation = 0;
+static uint32_t shown_generation = UINT32_MAX;
 
 // File state
 static int file_scroll = 0;
 
+// File search: the query is typed with multi-tap letters on the digit
+// keys. Matches are found by the next render, which also jumps to them.
+#define SEARCH_QUERY_MAX 24
+#define SEARCH_MAX_MATCHES 64
+#define MULTITAP_MS 1000
+static bool search_open = false;      // Search bar shown, digit keys type
+static bool search_bar_drawn = false; // Last file frame has the bar in it
+static char search_query[SEARCH_QUERY_MAX];
+static int search_len = 0;
+static bool search_dirty = false; // Query changed since the last search
+static int search_step = 0;       // Pending move to the next/previous match
+static uint16_t search_matches[SEARCH_MAX_MATCHES];
+static int search_match_count = 0;
+static int search_match = 0; // Current match
+static calx_key_t multitap_key = KEY_NONE;
+static int multitap_index = 0;
+static TickType_t multitap_tick = 0;
+
 // AI state
 static bool ai_has_more = false;
 
+// Marquee for an over-long selected row: a looping step counter
+#define MARQUEE_STEP_MS 50
+#define MARQUEE_LOOP_STEPS 1200 // Starts over after a minute
+static animation_t marquee_anim;
+static bool marquee_running = false; // A row overflowed in the last render
+static bool marquee_reset = false;   // Selection moved, start over
+
+// Views showing live values are refreshed while open
+#define DEBUG_INFO_REFRESH_MS 500
+#define SETTINGS_REFRESH_MS 1000
+static bool show_debug_info = false; // Settings > Advanced > Debug Info
+static TickType_t live_last_tick = 0;
+
+// Screen the frame buffer was last rendered for
+static calx_state_t rendered_screen = STATE_BOOT;
+
+// =============================================================================
+// Widgets
+// =============================================================================
+// Each screen is a fixed set of widgets. While the same set stays on screen
+// only the widgets whose content changed are redrawn; switching sets (or
+// drawing text content in between) redraws everything.
+
+static label_t title_label;    // Boot / not bound
+static label_t subtitle_label; // Boot / not bound
+static label_t idle_title;
+static status_bar_t idle_status;
+static label_t menu_cells[4];
+static label_t busy_label;
+static spinner_t busy_spinner;
+static label_t heading_label; // Error / low battery / WiFi setup
+static label_t detail_label;  // Error / low battery / WiFi setup
+static label_t bind_caption;
+static label_t bind_code_label;
+static label_t ota_label;
+static progress_t ota_bar;
+static status_bar_t settings_rule;
+static list_t settings_list;
+static list_t submenu_list;
+static label_t debug_lines[4];
+
+static widget_t *const splash_widgets[] = {&title_label.base,
+                                           &subtitle_label.base};
+static widget_t *const idle_widgets[] = {&idle_title.base, &idle_status.base};
+static widget_t *const menu_widgets[] = {&menu_cells[0].base,
+                                         &menu_cells[1].base,
+                                         &menu_cells[2].base,
+                                         &menu_cells[3].base};
+static widget_t *const busy_widgets[] = {&busy_label.base,
+                                         &busy_spinner.base};
+static widget_t *const heading_widgets[] = {&heading_label.base,
+                                            &detail_label.base};
+static widget_t *const bind_widgets[] = {&bind_caption.base,
+                                         &bind_code_label.base};
+static widget_t *const ota_widgets[] = {&ota_label.base, &ota_bar.base};
+static widget_t *const settings_widgets[] = {&settings_rule.base,
+                                             &settings_list.base};
+static widget_t *const submenu_widgets[] = {&submenu_list.base};
+static widget_t *const debug_widgets[] = {
+    &debug_lines[0].base, &debug_lines[1].base, &debug_lines[2].base,
+    &debug_lines[3].base};
+
+#define WIDGET_COUNT(set) ((int)(sizeof(set) / sizeof((set)[0])))
+
+// Widget set currently on screen, NULL after free-form drawing
+static widget_t *const *rendered_widgets = NULL;
+
+// Rows of the settings lists. Pages and entries are read from the settings
+// schema; only the open page's formatted values are kept.
+static const char *settings_titles[SETTINGS_MAX_PAGES];
+static const uint8_t *settings_icons[SETTINGS_MAX_PAGES];
+static int settings_pages = 0;
+static int loaded_page = -1; // Page the submenu rows were filled from
+static const char *submenu_labels[SETTINGS_PAGE_MAX_ITEMS];
+static char submenu_text[SETTINGS_PAGE_MAX_ITEMS][SETTING_VALUE_MAX];
+static const char *submenu_values[SETTINGS_PAGE_MAX_ITEMS];
+
+static void init_widgets(void) {
+  label_init(&title_label, 0, 8, DISPLAY_WIDTH, 16, TEXT_SIZE_LARGE,
+             ALIGN_CENTER);
+  label_set_text(&title_label, "CalX");
+  label_init(&subtitle_label, 0, 24, DISPLAY_WIDTH, 8, TEXT_SIZE_SMALL,
+             ALIGN_CENTER);
+
+  label_init(&idle_title, 0, 4, DISPLAY_WIDTH, 16, TEXT_SIZE_LARGE,
+             ALIGN_CENTER);
+  label_set_text(&idle_title, "CalX");
+  status_bar_init(&idle_status, 0, 22, DISPLAY_WIDTH, 8, false);
+
+  // 2x2 grid, the selected cell is inverted with an arrow at its edge
+  const char *cells[] = {"1.Chat", "3.AI", "2.File", "4.Set"};
+  for (int i = 0; i < 4; i++) {
+    label_init(&menu_cells[i], (i % 2) * 64, (i / 2) * 12 + 2, 60, 12,
+               TEXT_SIZE_SMALL, ALIGN_LEFT);
+    label_set_text(&menu_cells[i], cells[i]);
+    menu_cells[i].marker = (i % 2) ? '<' : '>';
+  }
+
+  label_init(&busy_label, 0, 8, DISPLAY_WIDTH, 12, TEXT_SIZE_MEDIUM,
+             ALIGN_CENTER);
+  spinner_init(&busy_spinner, (DISPLAY_WIDTH - 8) / 2, 22);
+
+  label_init(&heading_label, 0, 3, DISPLAY_WIDTH, 12, TEXT_SIZE_MEDIUM,
+             ALIGN_CENTER);
+  label_init(&detail_label, 0, 18, DISPLAY_WIDTH, 8, TEXT_SIZE_SMALL,
+             ALIGN_CENTER);
+
+  label_init(&bind_caption, 0, 4, DISPLAY_WIDTH, 8, TEXT_SIZE_SMALL,
+             ALIGN_CENTER);
+  label_set_text(&bind_caption, "Bind Code");
+  label_init(&bind_code_label, 0, 14, DISPLAY_WIDTH, 16, TEXT_SIZE_LARGE,
+             ALIGN_CENTER);
+
+  label_init(&ota_label, 0, 7, DISPLAY_WIDTH, 12, TEXT_SIZE_NORMAL,
+             ALIGN_CENTER);
+  progress_init(&ota_bar, 10, 22, 108, 6);
+
+  // Settings: a rule under the status line, then three icon rows
+  status_bar_init(&settings_rule, 0, 0, DISPLAY_WIDTH, 1, true);
+  list_init(&settings_list, 0, 1, DISPLAY_WIDTH, 10, 3);
+  list_init(&submenu_list, 0, 0, DISPLAY_WIDTH, 8, 4);
+
+  settings_pages = settings_menu_page_count();
+  if (settings_pages > SETTINGS_MAX_PAGES) {
+    settings_pages = SETTINGS_MAX_PAGES;
+  }
+  for (int i = 0; i < settings_pages; i++) {
+    settings_titles[i] = settings_menu_page(i)->title;
+    settings_icons[i] = settings_menu_page(i)->icon;
+  }
+  for (int i = 0; i < SETTINGS_PAGE_MAX_ITEMS; i++) {
+    submenu_values[i] = submenu_text[i];
+  }
+
+  for (int i = 0; i < 4; i++) {
+    label_init(&debug_lines[i], 0, i * 8, DISPLAY_WIDTH, 8, TEXT_SIZE_SMALL,
+               ALIGN_LEFT);
+  }
+}
+
+static void show_widgets(widget_t *const *widgets, int count) {
+  widget_render(widgets, count, widgets != rendered_widgets);
+  rendered_widgets = widgets;
+}
+
+// =============================================================================
+// Redraw Requests
+// =============================================================================
+
+// Mark the screen dirty and wake the UI task. Safe from any task.
+static void request_redraw(void) {
+  needs_redraw = true;
+  if (ui_task_handle) {
+    xTaskNotifyGive(ui_task_handle);
+  }
+}
+
+// Refresh period of the live view on screen, 0 if none is open
+static uint32_t live_refresh_ms(void) {
+  if (current_screen != STATE_SETTINGS) {
+    return 0;
+  }
+  if (show_debug_info) {
+    return DEBUG_INFO_REFRESH_MS;
+  }
+  return in_settings_submenu ? SETTINGS_REFRESH_MS : 0;
+}
+
+// Ticks until a periodic redraw is due, 0 if it already is
+static TickType_t ticks_until(TickType_t last, uint32_t period_ms,
+                              TickType_t now) {
+  TickType_t elapsed = now - last;
+  TickType_t period = pdMS_TO_TICKS(period_ms);
+  return (elapsed >= period) ? 0 : period - elapsed;
+}
+
 // =============================================================================
 // Initialization
 // =============================================================================
@@ -61,6 +297,9 @@ static bool ai_has_more = false;
 void ui_manager_init(void) {
   ui_mutex = xSemaphoreCreateMutex();
   text_renderer_init();
+  chat_history_init();
+  ui_metrics_init();
+  init_widgets();
   LOG_INFO(TAG, "UI manager initialized");
 }
 
@@ -69,26 +308,17 @@ void ui_manager_init(void) {
 // =============================================================================
 
 static void render_boot_screen(void) {
-  display_driver_clear();
-  display_driver_draw_text_centered(8, "CalX", TEXT_SIZE_LARGE);
-  display_driver_draw_text_centered(24, "Starting...", TEXT_SIZE_SMALL);
-  display_driver_update();
+  label_set_text(&subtitle_label, "Starting...");
+  show_widgets(splash_widgets, WIDGET_COUNT(splash_widgets));
 }
 
 static void render_not_bound_screen(void) {
-  display_driver_clear();
-  display_driver_draw_text_centered(8, "CalX", TEXT_SIZE_LARGE);
-  display_driver_draw_text_centered(24, "Not Bound", TEXT_SIZE_SMALL);
-  display_driver_update();
+  label_set_text(&subtitle_label, "Not Bound");
+  show_widgets(splash_widgets, WIDGET_COUNT(splash_widgets));
 }
 
 static void render_idle_screen(void) {
-  display_driver_clear();
-
-  // Line 1: CalX logo (centered)
-  display_driver_draw_text_centered(4, "CalX", TEXT_SIZE_LARGE);
-
-  // Line 2-3: Status line (ONLINE/OFFLINE + Battery + Notification)
+  // Status line: ONLINE/OFFLINE + battery, notification dot on the right
   char status[32];
   int battery = battery_manager_get_percent();
   bool online = wifi_manager_is_connected();
@@ -96,67 +326,139 @@ static void render_idle_screen(void) {
   snprintf(status, sizeof(status), "%s %d%%", online ? "ONLINE" : "OFFLINE",
            battery);
 
-  display_driver_draw_text_centered(22, status, TEXT_SIZE_SMALL);
-
-  // Notification dot (right side)
-  if (has_notification) {
-    display_driver_draw_text(120, 22, "*", TEXT_SIZE_SMALL);
-  }
-
-  display_driver_update();
+  status_bar_set_text(&idle_status, status);
+  status_bar_set_indicator(&idle_status, has_notification);
+  show_widgets(idle_widgets, WIDGET_COUNT(idle_widgets));
 }
 
 static void render_menu_screen(void) {
-  display_driver_clear();
+  for (int i = 0; i < 4; i++) {
+    label_set_selected(&menu_cells[i], i == menu_selection);
+  }
+  show_widgets(menu_widgets, WIDGET_COUNT(menu_widgets));
+}
 
-  // 2x2 grid menu
-  const char *items[] = {"1.Chat", "3.AI", "2.File", "4.Set"};
+static void render_busy_screen(void) {
+  if (!spinner_anim.running) {
+    animation_start(&spinner_anim, 0, SPINNER_FRAMES, SPINNER_PERIOD_MS,
+                    EASE_LINEAR, true);
+  }
+  label_set_text(&busy_label, busy_message);
+  spinner_set_frame(&busy_spinner, spinner_anim.value);
+  show_widgets(busy_widgets, WIDGET_COUNT(busy_widgets));
+}
 
-  // Row 1
-  display_driver_draw_text(0, 4, items[0], TEXT_SIZE_SMALL);
-  display_driver_draw_text(64, 4, items[1], TEXT_SIZE_SMALL);
+static void render_chat_screen(void) {
+  uint32_t first, end;
+  if (chat_history_get_range(&first, &end)) {
+    if (chat_follow || chat_message >= end) {
+      chat_message = end - 1;
+    } else if (chat_message < first) {
+      chat_message = first; // Evicted while shown
+    }
+  }
 
-  // Row 2
-  display_driver_draw_text(0, 16, items[2], TEXT_SIZE_SMALL);
-  display_driver_draw_text(64, 16, items[3], TEXT_SIZE_SMALL);
+  chat_more_below = chat_history_render(chat_message, chat_scroll,
+                                        storage_manager_get_text_size());
+  text_renderer_invalidate();
+  rendered_widgets = NULL;
 
-  // Selection indicator
-  int x = (menu_selection % 2) * 64;
-  int y = (menu_selection / 2) * 12 + 4;
+  display_driver_update();
+}
 
-  // Draw arrow before selected item
-  if (menu_selection == 0 || menu_selection == 2) {
-    display_driver_draw_text(56, y, ">", TEXT_SIZE_SMALL);
+// Put a text in the text renderer at the user's text size. Switching back
+// to a text or size shown recently reuses its cached line breaks.
+static void show_text(const screen_text_t *text) {
+  calx_text_size_t size = storage_manager_get_text_size();
+  if (text->generation != shown_generation) {
+    text_renderer_set_content(text->text, text->length, text->generation,
+                              size);
+    shown_generation = text->generation;
   } else {
-    display_driver_draw_text(120, y, "<", TEXT_SIZE_SMALL);
+    text_renderer_set_size(size);
   }
+}
 
-  // Invert selected item
-  display_driver_invert_rect(x, y - 2, 60, 12);
+// Redo the search after the query changed, then follow a pending jump.
+// Jumps put the match's line at the top of the screen.
+static void update_file_search(void) {
+  bool jump = false;
+
+  if (search_dirty) {
+    search_dirty = false;
+    search_match_count =
+        search_len ? text_renderer_find_all(search_query, search_matches,
+                                            SEARCH_MAX_MATCHES)
+                   : 0;
+
+    // Typing refines the search, so stay at the first match from the top
+    // of the screen on
+    search_match = 0;
+    while (search_match < search_match_count - 1 &&
+           text_renderer_line_at(search_matches[search_match]) <
+               file_scroll) {
+      search_match++;
+    }
+    jump = search_match_count > 0;
+  }
 
-  display_driver_update();
-}
+  if (search_step && search_match_count > 0) {
+    search_match = (search_match + search_step + search_match_count) %
+                   search_match_count;
+    jump = true;
+  }
+  search_step = 0;
 
-static void render_busy_screen(void) {
-  display_driver_clear();
-  display_driver_draw_text_centered(12, busy_message, TEXT_SIZE_NORMAL);
-  display_driver_update();
+  if (jump) {
+    file_scroll = text_renderer_line_at(search_matches[search_match]);
+  }
+  if (search_match_count > 0) {
+    text_renderer_set_highlight(search_matches[search_match], search_len);
+  } else {
+    text_renderer_set_highlight(-1, 0);
+  }
 }
 
-static void render_chat_screen(void) {
-  display_driver_clear();
-
-  // Render current chat message using text renderer
-  text_renderer_render_content(chat_scroll);
+// Bottom row while searching: the query and the current match
+static void draw_search_bar(void) {
+  char status[24];
+  if (search_match_count > 0) {
+    snprintf(status, sizeof(status), "%d/%d%s", search_match + 1,
+             search_match_count,
+             search_match_count == SEARCH_MAX_MATCHES ? "+" : "");
+  } else {
+    snprintf(status, sizeof(status), "%s", search_len ? "None" : "");
+  }
 
-  display_driver_update();
+  char query[SEARCH_QUERY_MAX + 1];
+  snprintf(query, sizeof(query), "/%s", search_query);
+
+  int y = DISPLAY_HEIGHT - 8;
+  display_driver_fill_rect(0, y, DISPLAY_WIDTH, 8, false);
+  display_driver_draw_text(1, y, query, TEXT_SIZE_SMALL);
+  display_driver_draw_text(
+      DISPLAY_WIDTH - 1 -
+          display_driver_get_text_width(status, TEXT_SIZE_SMALL),
+      y, status, TEXT_SIZE_SMALL);
+  display_driver_invert_rect(0, y, DISPLAY_WIDTH, 8);
 }
 
 static void render_file_screen(void) {
-  display_driver_clear();
-
-  // Render file content with small font (4 lines)
+  show_text(&file_text);
+  update_file_search();
+
+  // The bar covers the bottom content row, so rows shifted in place would
+  // carry it up the screen: redraw all of them while it is, or just was,
+  // on screen
+  if (search_open || search_bar_drawn) {
+    text_renderer_invalidate();
+  }
   text_renderer_render_content(file_scroll);
+  search_bar_drawn = search_open;
+  if (search_open) {
+    draw_search_bar();
+  }
+  rendered_widgets = NULL;
 
   display_driver_update();
 }
@@ -164,7 +466,9 @@ static void render_file_screen(void) {
 static void render_ai_screen(void) {
   display_driver_clear();
 
+  show_text(&ai_text);
   text_renderer_render_content(0);
+  rendered_widgets = NULL;
 
   // Show [More...] indicator if more content available
   if (ai_has_more) {
@@ -174,310 +478,235 @@ static void render_ai_screen(void) {
   display_driver_update();
 }
 
-static void render_display_settings(void) {
-  const char *items[] = {"Text Size", "Theme", "Contrast", "Timeout"};
-  const char *values[] = {"Normal", "Dark", "Med", "30s"}; // Placeholders
-
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
-
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
-    }
-  }
-}
-
-static void render_power_settings(void) {
-  const char *items[] = {"Power Mode", "Battery", "Charging", "Sleep"};
-  const char *values[] = {"Normal", "85%", "No", "Auto"}; // Placeholders
-
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
-
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
-    }
-  }
+// Render and flush figures summed over all screens; /metrics has them per
+// screen with histograms.
+static void render_debug_info(void) {
+  ui_screen_metrics_t m;
+  ui_metrics_get_total(&m);
+
+  char line[48];
+  uint32_t render_avg = m.render_us.count ? m.render_us.sum / m.render_us.count
+                                          : 0;
+  snprintf(line, sizeof(line), "Render %lu max %luus",
+           (unsigned long)render_avg, (unsigned long)m.render_us.max);
+  label_set_text(&debug_lines[0], line);
+
+  uint32_t flush_avg = m.flush_us.count ? m.flush_us.sum / m.flush_us.count
+                                        : 0;
+  uint32_t bytes_avg =
+      m.flush_bytes.count ? m.flush_bytes.sum / m.flush_bytes.count : 0;
+  snprintf(line, sizeof(line), "Flush %luus %luB", (unsigned long)flush_avg,
+           (unsigned long)bytes_avg);
+  label_set_text(&debug_lines[1], line);
+
+  snprintf(line, sizeof(line), "Frames %lu same %lu",
+           (unsigned long)m.frames, (unsigned long)m.frames_unchanged);
+  label_set_text(&debug_lines[2], line);
+
+  snprintf(line, sizeof(line), "Skip %lu drop %lu",
+           (unsigned long)m.frames_skipped, (unsigned long)m.frames_dropped);
+  label_set_text(&debug_lines[3], line);
+
+  show_widgets(debug_widgets, WIDGET_COUNT(debug_widgets));
 }
 
-static void render_device_settings(void) {
-  const char *items[] = {"Name", "ID", "Bind Status", "Unbind"};
-  const char *values[] = {"CalX", "8857...", "Bound", "Select"}; // Placeholders
-
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
-
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
-    }
-  }
-}
-
-static void render_internet_settings(void) {
-  const char *items[] = {"Status", "WiFi Setup", "Saved Network",
-                         "BLE Fallback"};
-  const char *values[] = {"Offline", "Scan...", "None", "Off"}; // Placeholders
-
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
+// =============================================================================
+// Settings Menus
+// =============================================================================
 
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
-    }
-  }
+// Number of rows on a settings page, capped at what the UI keeps
+static int page_items(const settings_page_t *page) {
+  return (page->count < SETTINGS_PAGE_MAX_ITEMS) ? page->count
+                                                 : SETTINGS_PAGE_MAX_ITEMS;
 }
 
-static void render_ai_config_settings(void) {
-  const char *items[] = {"Enabled", "Provider", "Model", "Length"};
-  const char *values[] = {"Yes", "OpenAI", "GPT-4o", "Normal"}; // Placeholders
+// Reformat the open page's values and redraw the rows whose text changed
+static void refresh_submenu(void) {
+  const settings_page_t *page = settings_menu_page(settings_selection);
+  int count = page_items(page);
 
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
-
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
+  if (loaded_page != settings_selection) {
+    for (int i = 0; i < count; i++) {
+      submenu_labels[i] = page->items[i].label;
+      submenu_text[i][0] = '\0';
     }
+    loaded_page = settings_selection;
+    widget_invalidate(&submenu_list.base);
   }
-}
 
-static void render_keyboard_settings(void) {
-  const char *items[] = {"Mode", "Key Repeat", "Long Press", "Shift"};
-  const char *values[] = {"T9", "Fast", "Med", "Toggle"}; // Placeholders
-
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
-
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
+  for (int i = 0; i < count; i++) {
+    char value[SETTING_VALUE_MAX];
+    settings_menu_format_value(&page->items[i], i == submenu_confirm, value,
+                               sizeof(value));
+    if (strcmp(value, submenu_text[i]) != 0) {
+      memcpy(submenu_text[i], value, sizeof(value));
+      list_invalidate_item(&submenu_list, i);
     }
   }
-}
-
-static void render_update_settings(void) {
-  const char *items[] = {"Version", "Check Now", "Auto Update", "Channel"};
-  const char *values[] = {"v1.0.0", "Select", "On", "Stable"}; // Placeholders
 
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
-
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
-    }
-  }
+  list_set_items(&submenu_list, submenu_labels, submenu_values, NULL, count);
 }
 
-static void render_advanced_settings(void) {
-  const char *items[] = {"Factory Reset", "Clear Cache", "Debug Info",
-                         "Reboot"};
-  const char *values[] = {"Select", "Select", "Select",
-                          "Select"}; // Placeholders
-
-  int start = (submenu_selection / 4) * 4;
-  for (int i = 0; i < 4 && (start + i) < 4; i++) {
-    int y = i * 8;
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s: %s", items[start + i],
-             values[start + i]);
-    display_driver_draw_text(0, y, buffer, TEXT_SIZE_SMALL);
-
-    if ((start + i) == submenu_selection) {
-      display_driver_invert_rect(0, y, 128, 8);
-    }
-  }
-}
-
-// =============================================================================
-// Icons (8x8 bitmaps)
-// =============================================================================
-
-static const uint8_t icon_internet[] = {0x00, 0x18, 0x3C, 0x66, 0xC3,
-                                        0x81, 0x00, 0x18}; // WiFi signalish
-
-static const uint8_t icon_ai[] = {0x18, 0x3C, 0x7E, 0xFF,
-                                  0xFF, 0x7E, 0x3C, 0x18}; // Brain/Sparkle
-
-static const uint8_t icon_keyboard[] = {0xFF, 0x81, 0xBD, 0xA5,
-                                        0xA5, 0xBD, 0x81, 0xFF}; // Keypad
-
-static const uint8_t icon_display[] = {0x18, 0x42, 0x81, 0x81,
-                                       0x81, 0x81, 0x42, 0x18}; // Screen/Eye
-
-static const uint8_t icon_power[] = {0x18, 0x3C, 0x3C, 0x3C,
-                                     0x3C, 0x3C, 0x3C, 0x18}; // Battery
-
-static const uint8_t icon_device[] = {0x3C, 0x42, 0x81, 0x99,
-                                      0x99, 0x81, 0x42, 0x3C}; // Chip
-
-static const uint8_t icon_update[] = {0x18, 0x3C, 0x7E, 0x18,
-                                      0x18, 0x18, 0x00, 0x7E}; // Download arrow
-
-static const uint8_t icon_advanced[] = {0x3C, 0x42, 0x99, 0xBD,
-                                        0xBD, 0x99, 0x42, 0x3C}; // Gear
-
 static void render_settings_screen(void) {
-  display_driver_clear();
-
-  if (in_settings_submenu) {
-    switch (settings_selection) {
-    case 0:
-      render_internet_settings();
-      break;
-    case 1:
-      render_ai_config_settings();
-      break;
-    case 2:
-      render_keyboard_settings();
-      break;
-    case 3:
-      render_display_settings();
-      break;
-    case 4:
-      render_power_settings();
-      break;
-    case 5:
-      render_device_settings();
-      break;
-    case 6:
-      render_update_settings();
-      break;
-    case 7:
-      render_advanced_settings();
-      break;
-    default:
-      display_driver_draw_text_centered(4, "Error", TEXT_SIZE_SMALL);
-      break;
+  if (show_debug_info) {
+    render_debug_info();
+  } else if (in_settings_submenu) {
+    refresh_submenu();
+    list_set_selected(&submenu_list, submenu_selection);
+    if (marquee_reset) {
+      animation_stop(&marquee_anim);
+      marquee_anim.value = 0;
+      marquee_reset = false;
     }
+    list_set_marquee_step(&submenu_list, marquee_anim.value);
+    show_widgets(submenu_widgets, WIDGET_COUNT(submenu_widgets));
+    marquee_running = submenu_list.marquee_active;
   } else {
-    // Modern Settings Menu
-    const char *items[] = {"Internet", "AI Config", "Keyboard", "Display",
-                           "Power",    "Device",    "Update",   "Advanced"};
-
-    const uint8_t *icons[] = {icon_internet, icon_ai,      icon_keyboard,
-                              icon_display,  icon_power,   icon_device,
-                              icon_update,   icon_advanced};
-
-    // Show 3 items at a time with icons (more spacing)
-    int items_per_page = 3;
-    int start = (settings_selection / items_per_page) * items_per_page;
-
-    // Status Bar separator
-    display_driver_draw_hline(0, 0, 128);
-
-    for (int i = 0; i < items_per_page && (start + i) < 8; i++) {
-      int item_idx = start + i;
-      int y_pos = 2 + (i * 10); // Spaced out list starting below status line
-
-      // Draw Icon
-      display_driver_draw_bitmap(2, y_pos, icons[item_idx], 8, 8);
-
-      // Draw Text
-      display_driver_draw_text(14, y_pos, items[item_idx], TEXT_SIZE_SMALL);
-
-      // Draw Selection Frame
-      if (item_idx == settings_selection) {
-        // Invert the whole row for selection
-        display_driver_invert_rect(0, y_pos - 1, 128, 10);
-      }
-    }
+    list_set_items(&settings_list, settings_titles, NULL, settings_icons,
+                   settings_pages);
+    list_set_selected(&settings_list, settings_selection);
+    show_widgets(settings_widgets, WIDGET_COUNT(settings_widgets));
   }
-
-  display_driver_update();
 }
 
 static void render_error_screen(void) {
-  display_driver_clear();
-  display_driver_draw_text_centered(4, "Error", TEXT_SIZE_NORMAL);
-  display_driver_draw_text_centered(18, error_message, TEXT_SIZE_SMALL);
-  display_driver_update();
+  label_set_text(&heading_label, "Error");
+  label_set_text(&detail_label, error_message);
+  show_widgets(heading_widgets, WIDGET_COUNT(heading_widgets));
 }
 
 static void render_low_battery_screen(void) {
-  display_driver_clear();
-  display_driver_draw_text_centered(4, "Low Battery", TEXT_SIZE_NORMAL);
-  display_driver_draw_text_centered(18, "Please Charge", TEXT_SIZE_SMALL);
-  display_driver_update();
+  label_set_text(&heading_label, "Low Battery");
+  label_set_text(&detail_label, "Please Charge");
+  show_widgets(heading_widgets, WIDGET_COUNT(heading_widgets));
 }
 
 static void render_ota_screen(void) {
-  display_driver_clear();
-
   char progress_str[16];
   snprintf(progress_str, sizeof(progress_str), "Updating... %d%%",
            ota_progress);
 
-  display_driver_draw_text_centered(8, progress_str, TEXT_SIZE_NORMAL);
-
-  // Progress bar
-  int bar_width = (100 * ota_progress) / 100;
-  display_driver_draw_rect(10, 22, 108, 6);
-  display_driver_fill_rect(12, 24, bar_width, 2, true);
+  if (ota_progress != ota_target) {
+    // Glide from where the bar is; the first percent shown is set directly
+    if (ota_target < 0) {
+      ota_anim.value = ota_progress;
+    } else {
+      animation_start(&ota_anim, ota_anim.value, ota_progress, OTA_GLIDE_MS,
+                      EASE_OUT, false);
+    }
+    ota_target = ota_progress;
+  }
 
-  display_driver_update();
+  label_set_text(&ota_label, progress_str);
+  progress_set_percent(&ota_bar, ota_anim.value);
+  show_widgets(ota_widgets, WIDGET_COUNT(ota_widgets));
 }
 
 static void render_bind_screen(void) {
-  display_driver_clear();
-  display_driver_draw_text_centered(4, "Bind Code", TEXT_SIZE_SMALL);
-  display_driver_draw_text_centered(14, bind_code, TEXT_SIZE_LARGE);
-  display_driver_update();
+  label_set_text(&bind_code_label, bind_code);
+  show_widgets(bind_widgets, WIDGET_COUNT(bind_widgets));
 }
 
 static void render_wifi_setup_screen(void) {
-  display_driver_clear();
-  display_driver_draw_text_centered(4, "WiFi Setup", TEXT_SIZE_NORMAL);
-  display_driver_draw_text_centered(18, "Connect to CalX-Setup",
-                                    TEXT_SIZE_SMALL);
-  display_driver_update();
+  label_set_text(&heading_label, "WiFi Setup");
+  label_set_text(&detail_label, "Connect to CalX-Setup");
+  show_widgets(heading_widgets, WIDGET_COUNT(heading_widgets));
 }
 
 // =============================================================================
 // Update (called from task)
 // =============================================================================
 
+// The menu slides over to the screens it opens and back
+static bool slides_between(calx_state_t from, calx_state_t to) {
+  calx_state_t screen = (from == STATE_MENU) ? to : from;
+  if (from != STATE_MENU && to != STATE_MENU) {
+    return false;
+  }
+  return screen == STATE_CHAT || screen == STATE_FILE || screen == STATE_AI ||
+         screen == STATE_SETTINGS;
+}
+
+bool ui_manager_in_transition(void) { return sliding; }
+
+void ui_manager_wait_redraw(void) {
+  ui_task_handle = xTaskGetCurrentTaskHandle();
+
+  // Sleep until a redraw is requested, or the next animation frame or live
+  // view refresh is due; nothing on screen changes otherwise.
+  TickType_t now = xTaskGetTickCount();
+  TickType_t timeout = animation_ticks_until_frame();
+  uint32_t refresh_ms = live_refresh_ms();
+  if (refresh_ms) {
+    TickType_t refresh = ticks_until(live_last_tick, refresh_ms, now);
+    if (refresh < timeout) {
+      timeout = refresh;
+    }
+  }
+
+  if (!needs_redraw && timeout > 0) {
+    ulTaskNotifyTake(pdTRUE, timeout);
+  }
+
+  // Cap the frame rate so a burst of requests becomes one frame
+  TickType_t since_frame = xTaskGetTickCount() - last_frame_tick;
+  TickType_t min_frame = pdMS_TO_TICKS(UI_MIN_FRAME_MS);
+  if (since_frame < min_frame) {
+    vTaskDelay(min_frame - since_frame);
+  }
+}
+
 void ui_manager_update(void) {
+  TickType_t now = xTaskGetTickCount();
+  if (animation_tick()) {
+    needs_redraw = true; // Widgets redraw only the animated parts
+  }
+
+  uint32_t refresh_ms = live_refresh_ms();
+  if (refresh_ms && (now - live_last_tick) >= pdMS_TO_TICKS(refresh_ms)) {
+    live_last_tick = now;
+    needs_redraw = true;
+  }
+
   if (!needs_redraw) {
+    ui_metrics_frame_skipped(current_screen);
     return;
   }
 
   if (xSemaphoreTake(ui_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+    ui_metrics_frame_dropped(current_screen);
     return;
   }
 
+  if (current_screen != rendered_screen) {
+    // Frame buffer holds another screen, text can't be scrolled in place
+    text_renderer_invalidate();
+    animation_stop_all();
+    ota_target = -1;
+
+    sliding = slides_between(rendered_screen, current_screen);
+    if (sliding) {
+      display_driver_save_frame(slide_from);
+      slide_from_left = (current_screen == STATE_MENU);
+      animation_start(&slide_anim, 0, DISPLAY_WIDTH, SLIDE_MS, EASE_OUT,
+                      false);
+    }
+    rendered_screen = current_screen;
+  }
+
+  // Mid-slide the buffer holds a composite, so draw the screen from scratch
+  // and only send it once it is slid into place
+  if (sliding) {
+    text_renderer_invalidate();
+    rendered_widgets = NULL;
+    display_driver_hold_updates(true);
+  }
+
+  // Cleared before rendering so a request made meanwhile isn't lost
+  needs_redraw = false;
+  marquee_running = false; // Set again by a row that still overflows
+  ui_metrics_render_begin();
+
   switch (current_screen) {
   case STATE_BOOT:
     render_boot_screen();
@@ -525,7 +754,24 @@ void ui_manager_update(void) {
     break;
   }
 
-  needs_redraw = false;
+  if (sliding) {
+    display_driver_hold_updates(false);
+    display_driver_draw_slide(slide_from, slide_anim.value, slide_from_left);
+    display_driver_update();
+    sliding = slide_anim.running;
+  }
+
+  // Keep the marquee stepping while a row overflows
+  if (!marquee_running) {
+    animation_stop(&marquee_anim);
+    marquee_anim.value = 0;
+  } else if (!marquee_anim.running) {
+    animation_start(&marquee_anim, 0, MARQUEE_LOOP_STEPS,
+                    MARQUEE_LOOP_STEPS * MARQUEE_STEP_MS, EASE_LINEAR, true);
+  }
+
+  ui_metrics_render_end(current_screen);
+  last_frame_tick = xTaskGetTickCount();
   xSemaphoreGive(ui_mutex);
 }
 
@@ -536,16 +782,18 @@ void ui_manager_update(void) {
 void ui_manager_on_state_change(calx_state_t new_state) {
   if (xSemaphoreTake(ui_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
     current_screen = new_state;
-    needs_redraw = true;
+    request_redraw();
 
     // Reset screen-specific state
     if (new_state == STATE_MENU) {
       menu_selection = 0;
     } else if (new_state == STATE_SETTINGS) {
       settings_selection = 0;
+      in_settings_submenu = false;
+      show_debug_info = false;
     } else if (new_state == STATE_CHAT) {
+      chat_follow = true;
       chat_scroll = 0;
-      chat_page = 0;
       has_notification = false; // Clear notification when entering chat
     }
 
@@ -562,57 +810,90 @@ void ui_manager_on_state_change(calx_state_t new_state) {
 
 void ui_manager_show_boot_screen(void) {
   current_screen = STATE_BOOT;
-  needs_redraw = true;
+  request_redraw();
 }
 
 void ui_manager_set_menu_selection(int selection) {
   if (selection >= 0 && selection <= 3) {
     menu_selection = selection;
-    needs_redraw = true;
+    request_redraw();
   }
 }
 
+void ui_manager_show_debug_info(void) {
+  show_debug_info = true;
+  request_redraw();
+}
+
 void ui_manager_set_notification(bool notification) {
   has_notification = notification;
   if (current_screen == STATE_IDLE) {
-    needs_redraw = true;
+    request_redraw();
   }
 }
 
 void ui_manager_show_busy(const char *message) {
   strncpy(busy_message, message, sizeof(busy_message) - 1);
   current_screen = STATE_BUSY;
-  needs_redraw = true;
+  request_redraw();
 }
 
 void ui_manager_show_error(const char *message) {
   strncpy(error_message, message, sizeof(error_message) - 1);
   current_screen = STATE_ERROR;
-  needs_redraw = true;
+  request_redraw();
 }
 
 void ui_manager_show_bind_code(const char *code) {
   strncpy(bind_code, code, 4);
   bind_code[4] = '\0';
-  needs_redraw = true;
+  request_redraw();
 }
 
 void ui_manager_show_ota_progress(int percent) {
   ota_progress = percent;
   current_screen = STATE_OTA_UPDATE;
-  needs_redraw = true;
+  request_redraw();
+}
+
+// Call with ui_mutex held
+static void set_screen_text(screen_text_t *screen, const char *text) {
+  screen->text = text ? text : "";
+  screen->length = strlen(screen->text);
+  screen->generation = ++text_generation;
 }
 
 void ui_manager_set_ai_response(const char *response, bool has_more) {
-  text_renderer_set_content(response, TEXT_SIZE_NORMAL);
+  // Waits out a render that may still be reading the previous text
+  xSemaphoreTake(ui_mutex, portMAX_DELAY);
+  set_screen_text(&ai_text, response);
   ai_has_more = has_more;
-  needs_redraw = true;
+  xSemaphoreGive(ui_mutex);
+  request_redraw();
+}
+
+void ui_manager_add_chat_message(const char *content, const char *sender,
+                                 const char *timestamp) {
+  if (chat_history_add(content, sender, timestamp) &&
+      current_screen == STATE_CHAT) {
+    if (chat_follow) {
+      chat_scroll = 0;
+    }
+    request_redraw(); // Position in the header changes either way
+  }
 }
 
 void ui_manager_set_file_content(const char *content) {
-  text_renderer_set_content(content, TEXT_SIZE_SMALL);
+  // Waits out a render that may still be reading the previous text
+  xSemaphoreTake(ui_mutex, portMAX_DELAY);
+  set_screen_text(&file_text, content);
   file_scroll = 0;
-  needs_redraw = true;
+  search_open = false;
+  search_len = 0;
+  search_query[0] = '\0';
+  search_dirty = true;
+  xSemaphoreGive(ui_mutex);
+  request_redraw();
 }
 
 // =============================================================================
@@ -624,11 +905,13 @@ void ui_manager_handle_chat_key(calx_key_t key) {
   case KEY_UP:
     if (chat_scroll > 0)
       chat_scroll--;
-    needs_redraw = true;
+    request_redraw();
     break;
   case KEY_DOWN:
-    chat_scroll++;
-    needs_redraw = true;
+    if (chat_more_below) {
+      chat_scroll++;
+      request_redraw();
+    }
     break;
   case KEY_OK:
     // Send a message - simplified for now
@@ -637,40 +920,113 @@ void ui_manager_handle_chat_key(calx_key_t key) {
     LOG_INFO("UI", "Chat message sent");
     break;
   case KEY_EQUALS:
-    chat_page++;
-    chat_scroll = 0;
-    needs_redraw = true;
-    break;
-  case KEY_DEL:
-    if (chat_page > 0) {
-      chat_page--;
-      chat_scroll = 0;
-      needs_redraw = true;
+  case KEY_DEL: {
+    // = pages to the next (newer) message, DEL to the previous one
+    uint32_t first, end;
+    if (!chat_history_get_range(&first, &end)) {
+      break;
     }
-    break;
+    if (key == KEY_EQUALS && chat_message + 1 < end) {
+      chat_message++;
+    } else if (key == KEY_DEL && chat_message > first) {
+      chat_message--;
+    } else {
+      break;
+    }
+    chat_follow = (chat_message + 1 == end);
+    chat_scroll = 0;
+    request_redraw();
+  } break;
   default:
     break;
   }
 }
 
+// Type a letter: presses of the same digit key in quick succession cycle
+// through its letters in place, like a phone keypad
+static void search_type(calx_key_t key) {
+  static const char *const letters[10] = {
+      " 0", ".,?!'-1", "abc2", "def3", "ghi4",
+      "jkl5", "mno6", "pqrs7", "tuv8", "wxyz9"};
+  const char *set = letters[key - KEY_0];
+  TickType_t now = xTaskGetTickCount();
+
+  if (key == multitap_key && search_len > 0 &&
+      now - multitap_tick < pdMS_TO_TICKS(MULTITAP_MS)) {
+    multitap_index = (multitap_index + 1) % strlen(set);
+    search_query[search_len - 1] = set[multitap_index];
+  } else if (search_len < SEARCH_QUERY_MAX - 1) {
+    multitap_index = 0;
+    search_query[search_len++] = set[0];
+    search_query[search_len] = '\0';
+  }
+  multitap_key = key;
+  multitap_tick = now;
+  search_dirty = true;
+}
+
+// Keys while the search bar is open; returns false for keys left to the
+// viewer
+static bool handle_search_key(calx_key_t key) {
+  if (key >= KEY_0 && key <= KEY_9) {
+    search_type(key);
+  } else if (key == KEY_DEL) {
+    if (search_len > 0) {
+      search_query[--search_len] = '\0';
+      search_dirty = true;
+    } else {
+      search_open = false; // DEL on an empty query closes the bar
+    }
+    multitap_key = KEY_NONE;
+  } else if (key == KEY_OK) {
+    search_open = false; // Keep the matches for LEFT/RIGHT
+    multitap_key = KEY_NONE;
+  } else {
+    return false;
+  }
+  request_redraw();
+  return true;
+}
+
 void ui_manager_handle_file_key(calx_key_t key) {
+  if (search_open && handle_search_key(key)) {
+    return;
+  }
+
   switch (key) {
+  case KEY_DIVIDE:
+    // Start a new search
+    search_open = true;
+    search_len = 0;
+    search_query[0] = '\0';
+    search_dirty = true;
+    multitap_key = KEY_NONE;
+    request_redraw();
+    break;
+  case KEY_LEFT:
+    search_step = -1; // Previous match
+    request_redraw();
+    break;
+  case KEY_RIGHT:
+    search_step = 1; // Next match
+    request_redraw();
+    break;
   case KEY_UP:
     if (file_scroll > 0)
       file_scroll--;
-    needs_redraw = true;
+    request_redraw();
     break;
   case KEY_DOWN:
     file_scroll++;
-    needs_redraw = true;
+    request_redraw();
     break;
   case KEY_EQUALS:
     file_scroll += 4;
-    needs_redraw = true;
+    request_redraw();
     break;
   case KEY_DEL:
     file_scroll = (file_scroll >= 4) ? file_scroll - 4 : 0;
-    needs_redraw = true;
+    request_redraw();
     break;
   default:
     break;
@@ -684,35 +1040,72 @@ void ui_manager_handle_ai_key(calx_key_t key) {
   }
 }
 
-void ui_manager_handle_settings_key(calx_key_t key) {
-  if (in_settings_submenu) {
-    if (key == KEY_AC) {
-      in_settings_submenu = false;
-      needs_redraw = true;
-      return;
+// Keys inside a settings page: every entry is handled by its type
+static void handle_submenu_key(calx_key_t key) {
+  const settings_page_t *page = settings_menu_page(settings_selection);
+  const setting_t *item = &page->items[submenu_selection];
+
+  switch (key) {
+  case KEY_AC:
+    in_settings_submenu = false;
+    break;
+  case KEY_UP:
+    if (submenu_selection > 0)
+      submenu_selection--;
+    submenu_confirm = -1;
+    marquee_reset = true;
+    break;
+  case KEY_DOWN:
+    if (submenu_selection < page_items(page) - 1)
+      submenu_selection++;
+    submenu_confirm = -1;
+    marquee_reset = true;
+    break;
+  case KEY_LEFT:
+  case KEY_RIGHT:
+    settings_menu_step(item, (key == KEY_RIGHT) ? 1 : -1);
+    break;
+  case KEY_OK:
+  case KEY_EQUALS:
+    if (item->type != SETTING_ACTION) {
+      settings_menu_step(item, 1);
+    } else if (item->confirm && submenu_confirm != submenu_selection) {
+      submenu_confirm = submenu_selection;
+    } else {
+      submenu_confirm = -1;
+      LOG_INFO("UI", "Settings action: %s", item->label);
+      item->action();
     }
+    break;
+  default:
+    return;
+  }
 
-    // Submenu navigation
-    switch (key) {
-    case KEY_UP:
-      if (submenu_selection > 0)
-        submenu_selection--;
-      needs_redraw = true;
-      break;
-    case KEY_DOWN:
-      if (submenu_selection < 3) // Default limit, will specialize per menu
-        submenu_selection++;
-      needs_redraw = true;
-      break;
-    case KEY_OK:
-    case KEY_EQUALS:
-      // TODO: Edit value
-      LOG_INFO("UI", "Edit setting: %d in menu %d", submenu_selection,
-               settings_selection);
-      break;
-    default:
-      break;
+  request_redraw();
+}
+
+bool ui_manager_handle_back(void) {
+  if (current_screen != STATE_SETTINGS ||
+      !(show_debug_info || in_settings_submenu)) {
+    return false;
+  }
+  ui_manager_handle_settings_key(KEY_AC);
+  return true;
+}
+
+void ui_manager_handle_settings_key(calx_key_t key) {
+  if (show_debug_info) {
+    if (key == KEY_AC || key == KEY_OK) {
+      show_debug_info = false;
+    } else if (key == KEY_EQUALS) {
+      ui_metrics_reset();
     }
+    request_redraw();
+    return;
+  }
+
+  if (in_settings_submenu) {
+    handle_submenu_key(key);
     return;
   }
 
@@ -721,32 +1114,28 @@ void ui_manager_handle_settings_key(calx_key_t key) {
   case KEY_UP:
     if (settings_selection > 0)
       settings_selection--;
-    needs_redraw = true;
+    request_redraw();
     break;
   case KEY_DOWN:
-    if (settings_selection < 7) // 8 items (0-7)
+    if (settings_selection < settings_pages - 1)
       settings_selection++;
-    needs_redraw = true;
+    request_redraw();
     break;
   case KEY_OK:
   case KEY_EQUALS:
     in_settings_submenu = true;
+    marquee_reset = true;
     submenu_selection = 0;
-    needs_redraw = true;
+    submenu_confirm = -1;
+    request_redraw();
     LOG_INFO("UI", "Entering settings submenu: %d", settings_selection);
     break;
-  case KEY_1:
-  case KEY_2:
-  case KEY_3:
-  case KEY_4:
-  case KEY_5:
-  case KEY_6:
-  case KEY_7:
-  case KEY_8:
-    settings_selection = key - KEY_1;
-    needs_redraw = true;
-    break;
   default:
+    // Number keys jump to a page
+    if (key >= KEY_1 && key < KEY_1 + settings_pages) {
+      settings_selection = key - KEY_1;
+      request_redraw();
+    }
     break;
   }
 }
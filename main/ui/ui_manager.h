@@ -14,11 +14,25 @@
  */
 void ui_manager_init(void);
 
+/**
+ * Block the UI task until there is something to draw
+ * Returns once a redraw has been requested or an animation step is due,
+ * and no sooner than UI_MIN_FRAME_MS after the previous frame.
+ */
+void ui_manager_wait_redraw(void);
+
 /**
  * Update display (called from UI task)
  */
 void ui_manager_update(void);
 
+/**
+ * Check whether a screen is still sliding in
+ * Opening a screen from the menu, or going back to it, slides the new
+ * screen in over a few animation frames.
+ */
+bool ui_manager_in_transition(void);
+
 /**
  * Show boot screen
  */
@@ -41,6 +55,8 @@ void ui_manager_handle_chat_key(calx_key_t key);
 
 /**
  * Handle key in file viewer
+ * / opens a search bar (digits type letters multi-tap style, DEL erases,
+ * OK closes it); LEFT/RIGHT jump to the previous/next match.
  */
 void ui_manager_handle_file_key(calx_key_t key);
 
@@ -51,26 +67,44 @@ void ui_manager_handle_ai_key(calx_key_t key);
 
 /**
  * Handle key in settings menu
+ * AC closes Debug Info or the open page (see ui_manager_handle_back()).
  */
 void ui_manager_handle_settings_key(calx_key_t key);
 
+/**
+ * Close the innermost view of the current screen, for a short AC press
+ * @return false when there is none and the state should go back instead
+ */
+bool ui_manager_handle_back(void);
+
+/**
+ * Open the Debug Info view of the settings screen
+ */
+void ui_manager_show_debug_info(void);
+
 /**
  * Set notification dot (new chat message)
  */
 void ui_manager_set_notification(bool has_notification);
 
 /**
- * Set chat messages for display
+ * Add a fetched chat message to the chat history (any task)
+ * Matches api_chat_message_cb_t.
  */
-void ui_manager_set_chat_messages(const char **messages, int count);
+void ui_manager_add_chat_message(const char *content, const char *sender,
+                                 const char *timestamp);
 
 /**
  * Set file content for display
+ * The text is drawn in place, not copied: keep it unchanged until replaced.
+ * Once this returns, no render reads the text it replaced.
  */
 void ui_manager_set_file_content(const char *content);
 
 /**
  * Set AI response for display
+ * The text is drawn in place, not copied: keep it unchanged until replaced.
+ * Once this returns, no render reads the text it replaced.
  */
 void ui_manager_set_ai_response(const char *response, bool has_more);
 
@@ -0,0 +1,218 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - UI Metrics
+ * =============================================================================
+ * Counts and times every UI wakeup per screen: render time, flush time and
+ * size, and wakeups that were skipped or dropped. Flushes finish on the display
+ * flush task after the render has returned, so their results are collected
+ * from the driver's statistics at the end of the following render.
+ * =============================================================================
+ */
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+#include "display_driver.h"
+#include "ui_metrics.h"
+
+// =============================================================================
+// State
+// =============================================================================
+static SemaphoreHandle_t metrics_mutex = NULL;
+static ui_screen_metrics_t screens[UI_METRICS_SCREENS];
+
+static int64_t render_start_us = 0;
+
+// Driver counters as of the last collection
+static uint32_t seen_frames = 0;
+static uint32_t seen_unchanged = 0;
+
+// Frame handed to the flush task and not yet timed. Every update that isn't
+// unchanged is flushed exactly once, so it is the flush numbered
+// frames - frames_unchanged.
+static int flush_screen = -1;
+static uint32_t flush_seq = 0;
+
+static const char *screen_names[UI_METRICS_SCREENS] = {
+    [STATE_BOOT] = "boot",
+    [STATE_NOT_BOUND] = "not_bound",
+    [STATE_BIND] = "bind",
+    [STATE_WIFI_SETUP] = "wifi_setup",
+    [STATE_IDLE] = "idle",
+    [STATE_MENU] = "menu",
+    [STATE_CHAT] = "chat",
+    [STATE_FILE] = "file",
+    [STATE_AI] = "ai",
+    [STATE_SETTINGS] = "settings",
+    [STATE_BUSY] = "busy",
+    [STATE_LOW_BATTERY] = "low_battery",
+    [STATE_ERROR] = "error",
+    [STATE_OTA_UPDATE] = "ota_update",
+};
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static void histogram_add(ui_histogram_t *hist, uint32_t value,
+                          uint32_t base) {
+  int bucket = 0;
+  while (bucket < UI_METRICS_BUCKETS - 1 && value >= (base << bucket)) {
+    bucket++;
+  }
+
+  hist->buckets[bucket]++;
+  hist->count++;
+  hist->sum += value;
+  if (value > hist->max) {
+    hist->max = value;
+  }
+}
+
+static void histogram_merge(ui_histogram_t *into, const ui_histogram_t *from) {
+  for (int i = 0; i < UI_METRICS_BUCKETS; i++) {
+    into->buckets[i] += from->buckets[i];
+  }
+  into->count += from->count;
+  into->sum += from->sum;
+  if (from->max > into->max) {
+    into->max = from->max;
+  }
+}
+
+static ui_screen_metrics_t *screen_metrics(calx_state_t screen) {
+  return (screen < UI_METRICS_SCREENS) ? &screens[screen] : NULL;
+}
+
+// Time the pending flush once it has landed. display_driver_update waits for
+// the previous flush before staging a new one, so by the end of a render the
+// flush of the frame before it is always done.
+static void collect_flush(const display_stats_t *stats) {
+  if (flush_screen >= 0 && stats->flushes == flush_seq) {
+    histogram_add(&screens[flush_screen].flush_us, stats->last_flush_us,
+                  UI_METRICS_TIME_BASE_US);
+    flush_screen = -1;
+  }
+}
+
+// =============================================================================
+// Initialization
+// =============================================================================
+
+void ui_metrics_init(void) {
+  metrics_mutex = xSemaphoreCreateMutex();
+  ui_metrics_reset();
+}
+
+void ui_metrics_reset(void) {
+  display_stats_t stats;
+  display_driver_get_stats(&stats);
+
+  xSemaphoreTake(metrics_mutex, portMAX_DELAY);
+  memset(screens, 0, sizeof(screens));
+  seen_frames = stats.frames;
+  seen_unchanged = stats.frames_unchanged;
+  flush_screen = -1;
+  xSemaphoreGive(metrics_mutex);
+}
+
+// =============================================================================
+// Recording (UI task)
+// =============================================================================
+
+void ui_metrics_frame_skipped(calx_state_t screen) {
+  ui_screen_metrics_t *m = screen_metrics(screen);
+  if (!m) {
+    return;
+  }
+
+  display_stats_t stats;
+  display_driver_get_stats(&stats);
+
+  xSemaphoreTake(metrics_mutex, portMAX_DELAY);
+  m->frames_skipped++;
+  collect_flush(&stats); // Last frame before going quiet
+  xSemaphoreGive(metrics_mutex);
+}
+
+void ui_metrics_frame_dropped(calx_state_t screen) {
+  ui_screen_metrics_t *m = screen_metrics(screen);
+  if (!m) {
+    return;
+  }
+
+  xSemaphoreTake(metrics_mutex, portMAX_DELAY);
+  m->frames_dropped++;
+  xSemaphoreGive(metrics_mutex);
+}
+
+void ui_metrics_render_begin(void) { render_start_us = esp_timer_get_time(); }
+
+void ui_metrics_render_end(calx_state_t screen) {
+  uint32_t render_us = esp_timer_get_time() - render_start_us;
+  ui_screen_metrics_t *m = screen_metrics(screen);
+  if (!m) {
+    return;
+  }
+
+  display_stats_t stats;
+  display_driver_get_stats(&stats);
+
+  xSemaphoreTake(metrics_mutex, portMAX_DELAY);
+  collect_flush(&stats);
+
+  m->frames++;
+  histogram_add(&m->render_us, render_us, UI_METRICS_TIME_BASE_US);
+
+  if (stats.frames != seen_frames) {
+    if (stats.frames_unchanged != seen_unchanged) {
+      m->frames_unchanged++;
+    } else {
+      histogram_add(&m->flush_bytes, stats.last_frame_bytes,
+                    UI_METRICS_BYTES_BASE);
+      flush_screen = screen;
+      flush_seq = stats.frames - stats.frames_unchanged;
+    }
+  }
+  seen_frames = stats.frames;
+  seen_unchanged = stats.frames_unchanged;
+  xSemaphoreGive(metrics_mutex);
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+void ui_metrics_get(calx_state_t screen, ui_screen_metrics_t *out) {
+  ui_screen_metrics_t *m = screen_metrics(screen);
+  if (!m) {
+    memset(out, 0, sizeof(*out));
+    return;
+  }
+
+  xSemaphoreTake(metrics_mutex, portMAX_DELAY);
+  *out = *m;
+  xSemaphoreGive(metrics_mutex);
+}
+
+void ui_metrics_get_total(ui_screen_metrics_t *out) {
+  memset(out, 0, sizeof(*out));
+
+  xSemaphoreTake(metrics_mutex, portMAX_DELAY);
+  for (int i = 0; i < UI_METRICS_SCREENS; i++) {
+    out->frames += screens[i].frames;
+    out->frames_skipped += screens[i].frames_skipped;
+    out->frames_dropped += screens[i].frames_dropped;
+    out->frames_unchanged += screens[i].frames_unchanged;
+    histogram_merge(&out->render_us, &screens[i].render_us);
+    histogram_merge(&out->flush_us, &screens[i].flush_us);
+    histogram_merge(&out->flush_bytes, &screens[i].flush_bytes);
+  }
+  xSemaphoreGive(metrics_mutex);
+}
+
+const char *ui_metrics_screen_name(calx_state_t screen) {
+  return (screen < UI_METRICS_SCREENS) ? screen_names[screen] : "unknown";
+}
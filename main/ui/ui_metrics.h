@@ -0,0 +1,99 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - UI Metrics Header
+ * =============================================================================
+ * Per-screen render and flush instrumentation for the UI pipeline.
+ * =============================================================================
+ */
+
+#ifndef UI_METRICS_H
+#define UI_METRICS_H
+
+#include "calx_config.h"
+#include <stdint.h>
+
+#define UI_METRICS_SCREENS (STATE_OTA_UPDATE + 1)
+#define UI_METRICS_BUCKETS 8
+
+/**
+ * Log2 histogram
+ * Bucket i counts values below base << i; the last bucket takes the rest.
+ */
+typedef struct {
+  uint32_t count;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t buckets[UI_METRICS_BUCKETS];
+} ui_histogram_t;
+
+/**
+ * Counters for one screen
+ */
+typedef struct {
+  uint32_t frames;            // Frames rendered
+  uint32_t frames_skipped;    // UI wakeups with nothing to redraw
+  uint32_t frames_dropped;    // Redraws put off because the UI was locked
+  uint32_t frames_unchanged;  // Rendered frames identical to the panel
+  ui_histogram_t render_us;   // Drawing plus staging the flush
+  ui_histogram_t flush_us;    // Bus time on the flush task
+  ui_histogram_t flush_bytes; // Payload bytes per flushed frame
+} ui_screen_metrics_t;
+
+// Smallest bucket bound of each histogram
+#define UI_METRICS_TIME_BASE_US 250
+#define UI_METRICS_BYTES_BASE 8
+
+/**
+ * Initialize metrics
+ */
+void ui_metrics_init(void);
+
+/**
+ * Record a UI wakeup that found nothing to redraw
+ * @param screen Screen being shown
+ */
+void ui_metrics_frame_skipped(calx_state_t screen);
+
+/**
+ * Record a UI wakeup that had to put off a redraw
+ * @param screen Screen being shown
+ */
+void ui_metrics_frame_dropped(calx_state_t screen);
+
+/**
+ * Mark the start of a render
+ */
+void ui_metrics_render_begin(void);
+
+/**
+ * Mark the end of a render and collect the display driver's flush results
+ * @param screen Screen that was rendered
+ */
+void ui_metrics_render_end(calx_state_t screen);
+
+/**
+ * Get a copy of one screen's metrics
+ * @param screen Screen to query
+ * @param out Output structure
+ */
+void ui_metrics_get(calx_state_t screen, ui_screen_metrics_t *out);
+
+/**
+ * Get the metrics of all screens added together
+ * @param out Output structure
+ */
+void ui_metrics_get_total(ui_screen_metrics_t *out);
+
+/**
+ * Get the short name of a screen
+ * @param screen Screen
+ * @return Lowercase name, e.g. "idle"
+ */
+const char *ui_metrics_screen_name(calx_state_t screen);
+
+/**
+ * Reset all counters
+ */
+void ui_metrics_reset(void);
+
+#endif // UI_METRICS_H
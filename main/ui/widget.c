@@ -0,0 +1,411 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Widgets
+ * =============================================================================
+ * Retained widgets for the 128x32 OLED. Each frame paints only dirty
+ * widgets (or dirty list rows) over the previous frame and hands just the
+ * painted area to the display flush.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_driver.h"
+#include "widget.h"
+
+// Marquee for an over-long selected row: hold at the start, slide a pixel
+// per step, hold at the end, then start over.
+#define MARQUEE_HOLD_STEPS 20
+
+#define ICON_SIZE 8
+#define ICON_TEXT_X 14 // Text column of rows with icons
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static void damage_add(widget_rect_t *damage, int x, int y, int width,
+                       int height) {
+  if (damage->x1 <= damage->x0) {
+    *damage = (widget_rect_t){x, y, x + width, y + height};
+    return;
+  }
+  if (x < damage->x0)
+    damage->x0 = x;
+  if (y < damage->y0)
+    damage->y0 = y;
+  if (x + width > damage->x1)
+    damage->x1 = x + width;
+  if (y + height > damage->y1)
+    damage->y1 = y + height;
+}
+
+// Clear a dirty widget's bounds and record them; false if it is clean
+static bool begin_paint(widget_t *widget, widget_rect_t *damage) {
+  if (!widget->dirty) {
+    return false;
+  }
+  display_driver_fill_rect(widget->x, widget->y, widget->width,
+                           widget->height, false);
+  damage_add(damage, widget->x, widget->y, widget->width, widget->height);
+  return true;
+}
+
+static int text_x(int x, int width, const char *text, calx_text_size_t size,
+                  widget_align_t align) {
+  if (align == ALIGN_CENTER) {
+    return x + (width - display_driver_get_text_width(text, size)) / 2;
+  }
+  return x;
+}
+
+static int text_y(int y, int height, calx_text_size_t size) {
+  return y + (height - display_driver_get_line_height(size)) / 2;
+}
+
+static void set_text(char *dest, const char *text, widget_t *widget) {
+  if (strncmp(dest, text, WIDGET_TEXT_MAX - 1) != 0) {
+    strncpy(dest, text, WIDGET_TEXT_MAX - 1);
+    dest[WIDGET_TEXT_MAX - 1] = '\0';
+    widget->dirty = true;
+  }
+}
+
+// =============================================================================
+// Rendering
+// =============================================================================
+
+void widget_invalidate(widget_t *widget) { widget->dirty = true; }
+
+void widget_render(widget_t *const *widgets, int count, bool full) {
+  widget_rect_t damage = {0, 0, 0, 0};
+
+  if (full) {
+    display_driver_clear();
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (full) {
+      widgets[i]->dirty = true;
+    }
+    widgets[i]->paint(widgets[i], &damage);
+    widgets[i]->dirty = false;
+  }
+
+  if (full) {
+    display_driver_update();
+  } else if (damage.x1 > damage.x0) {
+    display_driver_update_region(damage.x0, damage.y0,
+                                 damage.x1 - damage.x0,
+                                 damage.y1 - damage.y0);
+  }
+}
+
+// =============================================================================
+// Label
+// =============================================================================
+
+static void label_paint(widget_t *widget, widget_rect_t *damage) {
+  label_t *label = (label_t *)widget;
+  if (!begin_paint(widget, damage)) {
+    return;
+  }
+
+  display_driver_draw_text(text_x(widget->x, widget->width, label->text,
+                                  label->size, label->align),
+                           text_y(widget->y, widget->height, label->size),
+                           label->text, label->size);
+
+  if (label->selected) {
+    if (label->marker) {
+      char marker[2] = {label->marker, '\0'};
+      display_driver_draw_text(widget->x + widget->width - 4,
+                               text_y(widget->y, widget->height, label->size),
+                               marker, label->size);
+    }
+    display_driver_invert_rect(widget->x, widget->y, widget->width,
+                               widget->height);
+  }
+}
+
+void label_init(label_t *label, int x, int y, int width, int height,
+                calx_text_size_t size, widget_align_t align) {
+  memset(label, 0, sizeof(*label));
+  label->base = (widget_t){x, y, width, height, true, label_paint};
+  label->size = size;
+  label->align = align;
+}
+
+void label_set_text(label_t *label, const char *text) {
+  set_text(label->text, text, &label->base);
+}
+
+void label_set_selected(label_t *label, bool selected) {
+  if (label->selected != selected) {
+    label->selected = selected;
+    label->base.dirty = true;
+  }
+}
+
+// =============================================================================
+// List
+// =============================================================================
+
+static void list_paint_row(list_t *list, int index, int y) {
+  widget_t *widget = &list->base;
+  int x = widget->x;
+  int ty = text_y(y, list->row_height, TEXT_SIZE_SMALL);
+  bool selected = (index == list->selected);
+
+  if (list->icons) {
+    display_driver_draw_bitmap(x + 2, ty, list->icons[index], ICON_SIZE,
+                               ICON_SIZE);
+    x += ICON_TEXT_X;
+  }
+
+  char buffer[64];
+  if (list->values) {
+    snprintf(buffer, sizeof(buffer), "%s: %s", list->labels[index],
+             list->values[index]);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%s", list->labels[index]);
+  }
+
+  int avail = widget->x + widget->width - x;
+  int overflow = display_driver_get_text_width(buffer, TEXT_SIZE_SMALL) - avail;
+
+  if (selected && overflow > 0) {
+    int period = overflow + 2 * MARQUEE_HOLD_STEPS;
+    int offset = list->marquee_step % period - MARQUEE_HOLD_STEPS;
+    if (offset < 0)
+      offset = 0;
+    if (offset > overflow)
+      offset = overflow;
+
+    display_driver_draw_text_window(x, ty, avail, buffer, offset,
+                                    TEXT_SIZE_SMALL);
+    list->marquee_active = true;
+  } else {
+    display_driver_draw_text(x, ty, buffer, TEXT_SIZE_SMALL);
+  }
+
+  if (selected) {
+    display_driver_invert_rect(widget->x, y, widget->width, list->row_height);
+  }
+}
+
+static void list_paint(widget_t *widget, widget_rect_t *damage) {
+  list_t *list = (list_t *)widget;
+  uint32_t rows = widget->dirty ? ~0u : list->dirty_rows;
+
+  for (int i = 0; i < list->visible_rows; i++) {
+    if (!(rows & (1u << i))) {
+      continue;
+    }
+
+    int y = widget->y + i * list->row_height;
+    int index = list->first + i;
+    display_driver_fill_rect(widget->x, y, widget->width, list->row_height,
+                             false);
+    if (index == list->selected) {
+      list->marquee_active = false; // Set again if the row still overflows
+    }
+    if (index < list->count) {
+      list_paint_row(list, index, y);
+    }
+    damage_add(damage, widget->x, y, widget->width, list->row_height);
+  }
+
+  list->dirty_rows = 0;
+}
+
+static void list_mark_row(list_t *list, int index) {
+  int row = index - list->first;
+  if (row >= 0 && row < list->visible_rows) {
+    list->dirty_rows |= 1u << row;
+  }
+}
+
+void list_init(list_t *list, int x, int y, int width, int row_height,
+               int visible_rows) {
+  memset(list, 0, sizeof(*list));
+  if (visible_rows > LIST_MAX_VISIBLE_ROWS) {
+    visible_rows = LIST_MAX_VISIBLE_ROWS;
+  }
+  list->base =
+      (widget_t){x, y, width, row_height * visible_rows, true, list_paint};
+  list->row_height = row_height;
+  list->visible_rows = visible_rows;
+}
+
+void list_set_items(list_t *list, const char *const *labels,
+                    const char *const *values, const uint8_t *const *icons,
+                    int count) {
+  if (list->labels == labels && list->values == values &&
+      list->icons == icons && list->count == count) {
+    return;
+  }
+
+  list->labels = labels;
+  list->values = values;
+  list->icons = icons;
+  list->count = count;
+  if (list->selected >= count) {
+    list->selected = count > 0 ? count - 1 : 0;
+  }
+  list->first = (list->selected / list->visible_rows) * list->visible_rows;
+  list->marquee_active = false;
+  list->base.dirty = true;
+}
+
+void list_set_selected(list_t *list, int index) {
+  if (index < 0 || index >= list->count || index == list->selected) {
+    return;
+  }
+
+  int first = (index / list->visible_rows) * list->visible_rows;
+  if (first != list->first) {
+    list->first = first;
+    list->base.dirty = true; // Whole page changes
+  } else {
+    list_mark_row(list, list->selected);
+    list_mark_row(list, index);
+  }
+
+  list->selected = index;
+  list->marquee_step = 0;
+  list->marquee_active = false;
+}
+
+void list_invalidate_item(list_t *list, int index) {
+  list_mark_row(list, index);
+}
+
+void list_set_marquee_step(list_t *list, int step) {
+  if (step == list->marquee_step) {
+    return;
+  }
+  list->marquee_step = step;
+  if (list->marquee_active) {
+    list_mark_row(list, list->selected);
+  }
+}
+
+// =============================================================================
+// Progress Bar
+// =============================================================================
+
+static void progress_paint(widget_t *widget, widget_rect_t *damage) {
+  progress_t *progress = (progress_t *)widget;
+  if (!begin_paint(widget, damage)) {
+    return;
+  }
+
+  display_driver_draw_rect(widget->x, widget->y, widget->width,
+                           widget->height);
+  int fill = ((widget->width - 4) * progress->percent) / 100;
+  display_driver_fill_rect(widget->x + 2, widget->y + 2, fill,
+                           widget->height - 4, true);
+}
+
+void progress_init(progress_t *progress, int x, int y, int width,
+                   int height) {
+  memset(progress, 0, sizeof(*progress));
+  progress->base = (widget_t){x, y, width, height, true, progress_paint};
+}
+
+void progress_set_percent(progress_t *progress, int percent) {
+  if (percent < 0)
+    percent = 0;
+  if (percent > 100)
+    percent = 100;
+
+  if (progress->percent != percent) {
+    progress->percent = percent;
+    progress->base.dirty = true;
+  }
+}
+
+// =============================================================================
+// Spinner
+// =============================================================================
+
+#define SPINNER_SIZE 8
+#define SPINNER_TAIL 3 // Dots lit behind and including the head
+
+// Top-left of each 2x2 dot round the ring, clockwise from the top
+static const uint8_t spinner_dots[SPINNER_FRAMES][2] = {
+    {3, 0}, {5, 1}, {6, 3}, {5, 5}, {3, 6}, {1, 5}, {0, 3}, {1, 1}};
+
+static void spinner_paint(widget_t *widget, widget_rect_t *damage) {
+  spinner_t *spinner = (spinner_t *)widget;
+  if (!begin_paint(widget, damage)) {
+    return;
+  }
+
+  for (int i = 0; i < SPINNER_TAIL; i++) {
+    const uint8_t *dot =
+        spinner_dots[(spinner->frame - i + SPINNER_FRAMES) % SPINNER_FRAMES];
+    display_driver_fill_rect(widget->x + dot[0], widget->y + dot[1], 2, 2,
+                             true);
+  }
+}
+
+void spinner_init(spinner_t *spinner, int x, int y) {
+  memset(spinner, 0, sizeof(*spinner));
+  spinner->base =
+      (widget_t){x, y, SPINNER_SIZE, SPINNER_SIZE, true, spinner_paint};
+}
+
+void spinner_set_frame(spinner_t *spinner, int frame) {
+  frame %= SPINNER_FRAMES;
+  if (spinner->frame != frame) {
+    spinner->frame = frame;
+    spinner->base.dirty = true;
+  }
+}
+
+// =============================================================================
+// Status Bar
+// =============================================================================
+
+static void status_bar_paint(widget_t *widget, widget_rect_t *damage) {
+  status_bar_t *bar = (status_bar_t *)widget;
+  if (!begin_paint(widget, damage)) {
+    return;
+  }
+
+  int y = text_y(widget->y, widget->height, TEXT_SIZE_SMALL);
+  if (bar->text[0]) {
+    display_driver_draw_text(text_x(widget->x, widget->width, bar->text,
+                                    TEXT_SIZE_SMALL, ALIGN_CENTER),
+                             y, bar->text, TEXT_SIZE_SMALL);
+  }
+  if (bar->indicator) {
+    display_driver_draw_text(widget->x + widget->width - 8, y, "*",
+                             TEXT_SIZE_SMALL);
+  }
+  if (bar->rule) {
+    display_driver_draw_hline(widget->x, widget->y + widget->height - 1,
+                              widget->width);
+  }
+}
+
+void status_bar_init(status_bar_t *bar, int x, int y, int width, int height,
+                     bool rule) {
+  memset(bar, 0, sizeof(*bar));
+  bar->base = (widget_t){x, y, width, height, true, status_bar_paint};
+  bar->rule = rule;
+}
+
+void status_bar_set_text(status_bar_t *bar, const char *text) {
+  set_text(bar->text, text, &bar->base);
+}
+
+void status_bar_set_indicator(status_bar_t *bar, bool on) {
+  if (bar->indicator != on) {
+    bar->indicator = on;
+    bar->base.dirty = true;
+  }
+}
@@ -0,0 +1,186 @@
+/**
+ * =============================================================================
+ * CalX ESP32 Firmware - Widgets Header
+ * =============================================================================
+ * Retained widgets that remember their bounds and redraw only when their
+ * content changes. Setters mark a widget dirty only if the new content
+ * differs, so screens can push their whole model every frame.
+ * =============================================================================
+ */
+
+#ifndef WIDGET_H
+#define WIDGET_H
+
+#include "calx_config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define WIDGET_TEXT_MAX 40
+#define LIST_MAX_VISIBLE_ROWS 8
+
+/**
+ * Screen area touched by a render (x1/y1 exclusive, empty if x1 <= x0)
+ */
+typedef struct {
+  int x0, y0, x1, y1;
+} widget_rect_t;
+
+typedef struct widget widget_t;
+
+/**
+ * Common widget header, first member of every widget type
+ * paint() redraws what is dirty and adds the area it drew to the damage.
+ */
+struct widget {
+  int x, y, width, height;
+  bool dirty;
+  void (*paint)(widget_t *widget, widget_rect_t *damage);
+};
+
+typedef enum { ALIGN_LEFT = 0, ALIGN_CENTER } widget_align_t;
+
+/**
+ * Single line of text
+ * Drawn vertically centered in its bounds. While selected it is inverted
+ * and shows its marker character at the right edge.
+ */
+typedef struct {
+  widget_t base;
+  char text[WIDGET_TEXT_MAX];
+  calx_text_size_t size;
+  widget_align_t align;
+  bool selected;
+  char marker; // 0 for none
+} label_t;
+
+/**
+ * Selectable list of rows, paged by the number of visible rows
+ * Rows show "label: value" when values are given, and an 8x8 icon before
+ * the label when icons are given. A selected row wider than the list
+ * scrolls sideways by the marquee step.
+ */
+typedef struct {
+  widget_t base;
+  const char *const *labels;
+  const char *const *values;   // NULL for label-only rows
+  const uint8_t *const *icons; // NULL for rows without icons
+  int count;
+  int selected;
+  int first; // Index of the first visible row
+  int row_height;
+  int visible_rows;
+  int marquee_step;
+  bool marquee_active; // Selected row overflows and is scrolling
+  uint32_t dirty_rows; // Bit per visible row
+} list_t;
+
+/**
+ * Horizontal progress bar
+ */
+typedef struct {
+  widget_t base;
+  int percent;
+} progress_t;
+
+/**
+ * Busy spinner: a dot chasing round an 8x8 ring
+ */
+typedef struct {
+  widget_t base;
+  int frame;
+} spinner_t;
+
+#define SPINNER_FRAMES 8
+
+/**
+ * Status line: centered text, an optional indicator at the right edge and
+ * an optional rule along the bottom
+ */
+typedef struct {
+  widget_t base;
+  char text[WIDGET_TEXT_MAX];
+  bool indicator;
+  bool rule;
+} status_bar_t;
+
+// =============================================================================
+// Rendering
+// =============================================================================
+
+/**
+ * Mark a widget for a full redraw
+ */
+void widget_invalidate(widget_t *widget);
+
+/**
+ * Paint the dirty parts of a set of widgets and flush only the area drawn
+ * @param widgets Widgets making up the screen
+ * @param count Number of widgets
+ * @param full Clear the screen and redraw every widget (screen changed)
+ */
+void widget_render(widget_t *const *widgets, int count, bool full);
+
+// =============================================================================
+// Label
+// =============================================================================
+
+void label_init(label_t *label, int x, int y, int width, int height,
+                calx_text_size_t size, widget_align_t align);
+void label_set_text(label_t *label, const char *text);
+void label_set_selected(label_t *label, bool selected);
+
+// =============================================================================
+// List
+// =============================================================================
+
+void list_init(list_t *list, int x, int y, int width, int row_height,
+               int visible_rows);
+
+/**
+ * Replace the rows; redraws the whole list
+ * The arrays are referenced, not copied.
+ */
+void list_set_items(list_t *list, const char *const *labels,
+                    const char *const *values, const uint8_t *const *icons,
+                    int count);
+
+/**
+ * Move the selection; redraws the old and new rows, or the whole list when
+ * the selection moves to another page
+ */
+void list_set_selected(list_t *list, int index);
+
+/**
+ * Redraw one row after the text behind it changed in place
+ */
+void list_invalidate_item(list_t *list, int index);
+
+/**
+ * Advance the marquee of the selected row; redraws that row if it scrolls
+ */
+void list_set_marquee_step(list_t *list, int step);
+
+// =============================================================================
+// Progress Bar
+// =============================================================================
+
+void progress_init(progress_t *progress, int x, int y, int width, int height);
+void progress_set_percent(progress_t *progress, int percent);
+
+// =============================================================================
+// Spinner
+// =============================================================================
+
+void spinner_init(spinner_t *spinner, int x, int y);
+void spinner_set_frame(spinner_t *spinner, int frame);
+
+// =============================================================================
+// Status Bar
+// =============================================================================
+
+void status_bar_init(status_bar_t *bar, int x, int y, int width, int height,
+                     bool rule);
+void status_bar_set_text(status_bar_t *bar, const char *text);
+void status_bar_set_indicator(status_bar_t *bar, bool on);
+
+#endif // WIDGET_H
@@ -0,0 +1,50 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Trace Replay Tool
+ * =============================================================================
+ * Replays a trace dumped from a device:
+ *
+ *   curl -o trace.bin http://<device>/trace.bin
+ *   calx_replay trace.bin
+ *
+ * Prints the records and stops at the first one the host build does not
+ * reproduce. Exits non-zero if the trace did not replay in full.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_ui.h"
+#include "trace_replay.h"
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <trace.bin>\n", argv[0]);
+    return 2;
+  }
+
+  trace_record_t *records;
+  size_t count;
+  if (!trace_replay_load(argv[1], &records, &count)) {
+    fprintf(stderr, "%s: not a readable trace dump\n", argv[1]);
+    return 2;
+  }
+
+  host_ui_init();
+  size_t matched = trace_replay(records, count);
+
+  for (size_t i = 0; i < count && i <= matched; i++) {
+    const trace_record_t *r = &records[i];
+    printf("%c %10u ", i < matched ? ' ' : '!', r->time_us);
+    if (r->type == EVENT_NONE) {
+      printf("state %u -> %u (cause %u)\n", r->from, r->to, r->arg);
+    } else {
+      printf("event %u (key %u)\n", r->type, r->arg);
+    }
+  }
+  printf("%zu of %zu records reproduced\n", matched, count);
+
+  free(records);
+  return matched == count ? 0 : 1;
+}
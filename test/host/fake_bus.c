@@ -0,0 +1,216 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Fake I2C Bus
+ * =============================================================================
+ * SSD1306 model: horizontal addressing within the COLUMNADDR/PAGEADDR
+ * window, the display start line, on/off and inversion. Commands it does
+ * not model are parsed for their argument count and ignored.
+ * =============================================================================
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "driver/i2c.h"
+#include "fake_bus.h"
+
+// =============================================================================
+// Panel Model
+// =============================================================================
+#define GDDRAM_PAGES 8
+#define GDDRAM_ROWS (GDDRAM_PAGES * 8)
+
+#define CONTROL_CO 0x80 // One byte follows, then another control byte
+#define CONTROL_DC 0x40 // Data rather than commands
+
+typedef struct {
+  uint8_t gddram[GDDRAM_PAGES][DISPLAY_WIDTH];
+  uint8_t col_start, col_end, page_start, page_end;
+  uint8_t col, page; // Write pointer
+  uint8_t start_line;
+  bool display_on;
+  bool inverted;
+
+  // Command being assembled
+  uint8_t command;
+  uint8_t args[2];
+  int args_needed;
+  int args_seen;
+} panel_t;
+
+static panel_t panel = {
+    .col_end = DISPLAY_WIDTH - 1,
+    .page_end = GDDRAM_PAGES - 1,
+};
+
+static fake_bus_counters_t counters;
+static uint32_t bus_hz = 0;
+static pthread_mutex_t bus_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Arguments taken by each command byte
+static int command_args(uint8_t cmd) {
+  switch (cmd) {
+  case 0x21: // COLUMNADDR
+  case 0x22: // PAGEADDR
+    return 2;
+  case 0x20: // MEMORYMODE
+  case 0x81: // SETCONTRAST
+  case 0x8D: // CHARGEPUMP
+  case 0xA8: // SETMULTIPLEX
+  case 0xD3: // SETDISPLAYOFFSET
+  case 0xD5: // SETDISPLAYCLOCKDIV
+  case 0xD9: // SETPRECHARGE
+  case 0xDA: // SETCOMPINS
+  case 0xDB: // SETVCOMDETECT
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+static void run_command(void) {
+  uint8_t cmd = panel.command;
+
+  if (cmd == 0x21) {
+    panel.col_start = panel.args[0] % DISPLAY_WIDTH;
+    panel.col_end = panel.args[1] % DISPLAY_WIDTH;
+    panel.col = panel.col_start;
+  } else if (cmd == 0x22) {
+    panel.page_start = panel.args[0] % GDDRAM_PAGES;
+    panel.page_end = panel.args[1] % GDDRAM_PAGES;
+    panel.page = panel.page_start;
+  } else if ((cmd & 0xC0) == 0x40) {
+    panel.start_line = cmd & 0x3F;
+  } else if (cmd == 0xAE || cmd == 0xAF) {
+    panel.display_on = (cmd == 0xAF);
+  } else if (cmd == 0xA6 || cmd == 0xA7) {
+    panel.inverted = (cmd == 0xA7);
+  }
+}
+
+static void put_command(uint8_t byte) {
+  if (panel.args_seen < panel.args_needed) {
+    panel.args[panel.args_seen++] = byte;
+  } else {
+    panel.command = byte;
+    panel.args_needed = command_args(byte);
+    panel.args_seen = 0;
+  }
+  if (panel.args_seen == panel.args_needed) {
+    run_command();
+    panel.args_needed = 0;
+    panel.args_seen = 0;
+  }
+}
+
+static void put_data(uint8_t byte) {
+  panel.gddram[panel.page][panel.col] = byte;
+  counters.data_bytes++;
+
+  if (panel.col != panel.col_end) {
+    panel.col = (panel.col + 1) % DISPLAY_WIDTH;
+    return;
+  }
+  panel.col = panel.col_start;
+  panel.page = (panel.page == panel.page_end)
+                   ? panel.page_start
+                   : (panel.page + 1) % GDDRAM_PAGES;
+}
+
+static void decode(const uint8_t *buf, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    uint8_t control = buf[i++];
+    bool data = control & CONTROL_DC;
+    size_t end = (control & CONTROL_CO) ? i + 1 : len;
+
+    for (; i < end && i < len; i++) {
+      if (data) {
+        put_data(buf[i]);
+      } else {
+        put_command(buf[i]);
+      }
+    }
+  }
+}
+
+// =============================================================================
+// I2C Master
+// =============================================================================
+
+esp_err_t i2c_param_config(i2c_port_t port, const i2c_config_t *conf) {
+  return ESP_OK;
+}
+
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode,
+                             size_t slv_rx_buf_len, size_t slv_tx_buf_len,
+                             int intr_alloc_flags) {
+  return ESP_OK;
+}
+
+esp_err_t i2c_master_write_to_device(i2c_port_t port, uint8_t address,
+                                     const uint8_t *write_buffer,
+                                     size_t write_size,
+                                     TickType_t ticks_to_wait) {
+  if (address != DISPLAY_I2C_ADDR) {
+    return ESP_FAIL; // Nothing acknowledges
+  }
+
+  pthread_mutex_lock(&bus_lock);
+  counters.transactions++;
+  counters.bytes += write_size;
+  decode(write_buffer, write_size);
+  uint32_t hz = bus_hz;
+  pthread_mutex_unlock(&bus_lock);
+
+  if (hz) {
+    // Start, address byte, payload and stop; 9 clocks per byte with ACK
+    uint64_t bits = 2 + 9 * (1 + (uint64_t)write_size);
+    uint64_t ns = bits * 1000000000ull / hz;
+    struct timespec ts = {.tv_sec = ns / 1000000000ull,
+                          .tv_nsec = ns % 1000000000ull};
+    nanosleep(&ts, NULL);
+  }
+  return ESP_OK;
+}
+
+// =============================================================================
+// Test Interface
+// =============================================================================
+
+void fake_bus_get_counters(fake_bus_counters_t *out) {
+  pthread_mutex_lock(&bus_lock);
+  *out = counters;
+  pthread_mutex_unlock(&bus_lock);
+}
+
+void fake_bus_reset_counters(void) {
+  pthread_mutex_lock(&bus_lock);
+  memset(&counters, 0, sizeof(counters));
+  pthread_mutex_unlock(&bus_lock);
+}
+
+void fake_bus_set_speed(uint32_t hz) {
+  pthread_mutex_lock(&bus_lock);
+  bus_hz = hz;
+  pthread_mutex_unlock(&bus_lock);
+}
+
+void fake_bus_read_panel(uint8_t *out) {
+  memset(out, 0, FAKE_BUS_FRAME_BYTES);
+
+  pthread_mutex_lock(&bus_lock);
+  if (panel.display_on) {
+    for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+      int row = (panel.start_line + y) % GDDRAM_ROWS;
+      for (int x = 0; x < DISPLAY_WIDTH; x++) {
+        bool lit = (panel.gddram[row / 8][x] >> (row & 7)) & 1;
+        if (lit != panel.inverted) {
+          out[(y / 8) * DISPLAY_WIDTH + x] |= 1 << (y & 7);
+        }
+      }
+    }
+  }
+  pthread_mutex_unlock(&bus_lock);
+}
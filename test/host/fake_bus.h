@@ -0,0 +1,52 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Fake I2C Bus
+ * =============================================================================
+ * Implements the I2C master calls on top of a model of the SSD1306: it
+ * decodes the control bytes, commands and data the display driver sends
+ * into a 64-row GDDRAM, so tests can check what the glass would show and
+ * count what crossed the bus.
+ * =============================================================================
+ */
+
+#ifndef FAKE_BUS_H
+#define FAKE_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "calx_config.h"
+
+#define FAKE_BUS_FRAME_BYTES (DISPLAY_WIDTH * DISPLAY_HEIGHT / 8)
+
+typedef struct {
+  uint32_t transactions; // I2C writes
+  uint32_t bytes;        // Bytes after the address, control bytes included
+  uint32_t data_bytes;   // Bytes written to GDDRAM
+} fake_bus_counters_t;
+
+/**
+ * Read the counters, summed since the last reset
+ */
+void fake_bus_get_counters(fake_bus_counters_t *out);
+
+/**
+ * Zero the counters
+ */
+void fake_bus_reset_counters(void);
+
+/**
+ * Make every transaction take as long as it would on the wire
+ * @param hz Bus clock, 0 for transfers that take no time (the default)
+ */
+void fake_bus_set_speed(uint32_t hz);
+
+/**
+ * Read what the panel shows, in frame buffer layout
+ * Rows come from GDDRAM through the display start line; a panel that is
+ * off shows nothing, an inverted one shows every pixel flipped.
+ * @param panel FAKE_BUS_FRAME_BYTES bytes
+ */
+void fake_bus_read_panel(uint8_t *panel);
+
+#endif // FAKE_BUS_H
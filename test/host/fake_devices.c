@@ -0,0 +1,166 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Fake Devices
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "api_client.h"
+#include "battery_manager.h"
+#include "esp_system.h"
+#include "fake_devices.h"
+#include "ota_manager.h"
+#include "power_manager.h"
+#include "security_manager.h"
+#include "storage_manager.h"
+#include "wifi_manager.h"
+
+fake_devices_t fake_devices;
+
+void fake_devices_reset(void) {
+  fake_devices = (fake_devices_t){
+      .battery_percent = 87,
+      .battery_mv = 4012,
+      .wifi_connected = true,
+      .ssid = "HomeNet",
+      .ip = "192.168.1.42",
+      .rssi = -61,
+      .bound = true,
+      .device_id = "calx-8857a1c0ffee",
+      .text_size = TEXT_SIZE_SMALL,
+      .keyboard = KEYBOARD_T9,
+      .power_mode = POWER_MODE_NORMAL,
+      .screen_timeout_s = 30,
+  };
+}
+
+// =============================================================================
+// Battery
+// =============================================================================
+
+int battery_manager_get_percent(void) { return fake_devices.battery_percent; }
+
+int battery_manager_get_voltage_mv(void) { return fake_devices.battery_mv; }
+
+bool battery_manager_is_charging(void) { return fake_devices.charging; }
+
+// =============================================================================
+// WiFi
+// =============================================================================
+
+bool wifi_manager_is_connected(void) { return fake_devices.wifi_connected; }
+
+const char *wifi_manager_get_ssid(void) { return fake_devices.ssid; }
+
+const char *wifi_manager_get_ip(void) { return fake_devices.ip; }
+
+int8_t wifi_manager_get_rssi(void) { return fake_devices.rssi; }
+
+void wifi_manager_start_ap(void) { fake_devices.ap_starts++; }
+
+// =============================================================================
+// Power
+// =============================================================================
+
+calx_power_mode_t power_manager_get_mode(void) {
+  return fake_devices.power_mode;
+}
+
+void power_manager_set_mode(calx_power_mode_t mode) {
+  fake_devices.power_mode = mode;
+}
+
+int power_manager_get_screen_timeout(void) {
+  return fake_devices.screen_timeout_s;
+}
+
+void power_manager_set_screen_timeout(int seconds) {
+  fake_devices.screen_timeout_s = seconds;
+}
+
+void power_manager_reset_timeout(void) {}
+
+// =============================================================================
+// Storage
+// =============================================================================
+
+calx_text_size_t storage_manager_get_text_size(void) {
+  return fake_devices.text_size;
+}
+
+void storage_manager_set_text_size(calx_text_size_t size) {
+  fake_devices.text_size = size;
+}
+
+calx_keyboard_t storage_manager_get_keyboard(void) {
+  return fake_devices.keyboard;
+}
+
+void storage_manager_set_keyboard(calx_keyboard_t keyboard) {
+  fake_devices.keyboard = keyboard;
+}
+
+void storage_manager_factory_reset(void) { fake_devices.factory_resets++; }
+
+void storage_manager_clear_cache(void) {}
+
+void esp_restart(void) { fake_devices.restarts++; }
+
+// =============================================================================
+// Security
+// =============================================================================
+
+bool security_manager_get_device_id(char *device_id, size_t max_len) {
+  snprintf(device_id, max_len, "%s", fake_devices.device_id);
+  return true;
+}
+
+bool security_manager_is_bound(void) { return fake_devices.bound; }
+
+void security_manager_unbind(void) {
+  fake_devices.bound = false;
+  fake_devices.unbinds++;
+}
+
+// =============================================================================
+// OTA
+// =============================================================================
+
+const char *ota_manager_get_available_version(void) {
+  return fake_devices.ota_version;
+}
+
+// =============================================================================
+// API Client
+// =============================================================================
+
+int api_client_fetch_chat(api_chat_message_cb_t on_message, int max_messages,
+                          const char *since) {
+  int count = 0;
+  for (int i = 0; i < fake_devices.chat_count && count < max_messages; i++) {
+    const fake_chat_message_t *msg = &fake_devices.chat[i];
+    if (since && strcmp(msg->timestamp, since) <= 0) {
+      continue; // Already cached
+    }
+    on_message(msg->content, msg->sender, msg->timestamp);
+    count++;
+  }
+  return count;
+}
+
+bool api_client_send_chat(const char *content) {
+  fake_devices.chats_sent++;
+  return true;
+}
+
+bool api_client_fetch_file(file_content_t *file) {
+  if (!fake_devices.file_text) {
+    return false;
+  }
+  snprintf(file->content, sizeof(file->content), "%s",
+           fake_devices.file_text);
+  file->char_count = strlen(file->content);
+  return true;
+}
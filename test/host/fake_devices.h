@@ -0,0 +1,64 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Fake Devices
+ * =============================================================================
+ * Stand-ins for the modules that talk to hardware or the network (battery,
+ * WiFi, storage, security, power, OTA, API client). Tests set what they
+ * report through fake_devices and read back what was asked of them.
+ * =============================================================================
+ */
+
+#ifndef FAKE_DEVICES_H
+#define FAKE_DEVICES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "calx_config.h"
+
+typedef struct {
+  const char *content;
+  const char *sender;
+  const char *timestamp;
+} fake_chat_message_t;
+
+typedef struct {
+  // Reported state
+  int battery_percent;
+  int battery_mv;
+  bool charging;
+  bool wifi_connected;
+  const char *ssid;
+  const char *ip;
+  int8_t rssi;
+  bool bound;
+  const char *device_id;
+  const char *ota_version; // NULL when no update is available
+
+  // Settings
+  calx_text_size_t text_size;
+  calx_keyboard_t keyboard;
+  calx_power_mode_t power_mode;
+  int screen_timeout_s;
+
+  // Served by the API client; NULL file_text fails the fetch
+  const char *file_text;
+  const fake_chat_message_t *chat;
+  int chat_count;
+
+  // Calls made
+  int ap_starts;
+  int restarts;
+  int factory_resets;
+  int unbinds;
+  int chats_sent;
+} fake_devices_t;
+
+extern fake_devices_t fake_devices;
+
+/**
+ * Put every fake back to its defaults: online, bound, battery at 87%
+ */
+void fake_devices_reset(void);
+
+#endif // FAKE_DEVICES_H
@@ -0,0 +1,83 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - UI Driver
+ * =============================================================================
+ */
+
+#include <string.h>
+
+#include "animation.h"
+#include "display_driver.h"
+#include "event_manager.h"
+#include "fake_devices.h"
+#include "host_clock.h"
+#include "host_ui.h"
+#include "logger.h"
+#include "system_state.h"
+#include "timer_wheel.h"
+#include "ui_manager.h"
+
+#define FLUSH_TIMEOUT_MS 1000
+
+void host_ui_init(void) {
+  fake_devices_reset();
+
+  logger_init();
+  display_driver_init();
+  ui_manager_init();
+  ui_manager_show_boot_screen();
+  event_manager_init();
+  timer_wheel_init();
+  system_state_init();
+}
+
+void host_ui_key(calx_key_t key) {
+  event_manager_post_key(key, false);
+  event_manager_process();
+}
+
+void host_ui_long_key(calx_key_t key) {
+  event_manager_post_key(key, true);
+  event_manager_process();
+}
+
+void host_ui_network(void) { timer_wheel_process(); }
+
+void host_ui_frame(host_frame_t *frame) {
+  display_driver_wait_flush(FLUSH_TIMEOUT_MS);
+  fake_bus_reset_counters();
+
+  uint64_t start = host_clock_wall_ns();
+  ui_manager_update();
+  uint64_t end = host_clock_wall_ns();
+  display_driver_wait_flush(FLUSH_TIMEOUT_MS);
+
+  if (frame) {
+    uint8_t panel[FAKE_BUS_FRAME_BYTES];
+    fake_bus_read_panel(panel);
+
+    frame->render_ns = end - start;
+    fake_bus_get_counters(&frame->bus);
+    frame->panel_matches = memcmp(panel, display_driver_get_buffer(),
+                                  FAKE_BUS_FRAME_BYTES) == 0;
+    frame->frames = 1;
+  }
+}
+
+void host_ui_finish_transition(host_frame_t *frame) {
+  host_frame_t next;
+
+  while (ui_manager_in_transition()) {
+    host_clock_advance_us(ANIMATION_FRAME_MS * 1000);
+    host_ui_frame(&next);
+
+    frame->render_ns += next.render_ns;
+    frame->bus.transactions += next.bus.transactions;
+    frame->bus.bytes += next.bus.bytes;
+    frame->bus.data_bytes += next.bus.data_bytes;
+    frame->panel_matches &= next.panel_matches;
+    frame->frames++;
+  }
+}
+
+void host_ui_read_panel(uint8_t *panel) { fake_bus_read_panel(panel); }
@@ -0,0 +1,69 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - UI Driver
+ * =============================================================================
+ * Brings up the firmware's display, UI and state machine on the fake bus
+ * and runs them from the test's thread: keys go through the event manager
+ * and frames are rendered one at a time, each waited out until it is on
+ * the panel.
+ * =============================================================================
+ */
+
+#ifndef HOST_UI_H
+#define HOST_UI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "calx_config.h"
+#include "fake_bus.h"
+
+typedef struct {
+  uint64_t render_ns;      // Wall-clock time of ui_manager_update()
+  fake_bus_counters_t bus; // What the frame sent
+  bool panel_matches;      // Panel shows exactly the frame buffer
+  int frames;              // Frames rendered; a slide takes several
+} host_frame_t;
+
+/**
+ * Initialize the modules in app_main's order and reset the fake devices
+ * Call once per process.
+ */
+void host_ui_init(void);
+
+/**
+ * Press a key and dispatch it
+ */
+void host_ui_key(calx_key_t key);
+
+/**
+ * Long-press a key and dispatch it
+ */
+void host_ui_long_key(calx_key_t key);
+
+/**
+ * Run the network task's due work, such as the chat and file fetches on
+ * entering a screen, against the fake API client
+ */
+void host_ui_network(void);
+
+/**
+ * Render a frame if one is due and wait until the panel has it
+ * @param frame Filled with what the frame cost, may be NULL
+ */
+void host_ui_frame(host_frame_t *frame);
+
+/**
+ * Render frames a frame period of simulated time apart until a screen
+ * transition has slid all the way in
+ * @param frame What those frames cost is added to it
+ */
+void host_ui_finish_transition(host_frame_t *frame);
+
+/**
+ * Read what the panel shows
+ * @param panel FAKE_BUS_FRAME_BYTES bytes
+ */
+void host_ui_read_panel(uint8_t *panel);
+
+#endif // HOST_UI_H
@@ -0,0 +1,76 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - PBM Images
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "calx_config.h"
+#include "pbm.h"
+
+#define FRAME_BYTES (DISPLAY_WIDTH * DISPLAY_HEIGHT / 8)
+#define ROW_BYTES (DISPLAY_WIDTH / 8)
+
+static const char header[] = "P4\n128 32\n";
+
+static bool frame_pixel(const uint8_t *frame, int x, int y) {
+  return (frame[(y / 8) * DISPLAY_WIDTH + x] >> (y & 7)) & 1;
+}
+
+bool pbm_write(const char *path, const uint8_t *frame) {
+  // Rows of 1-bit pixels, leftmost pixel in the high bit, 1 is lit
+  uint8_t image[FRAME_BYTES];
+  memset(image, 0, sizeof(image));
+  for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+    for (int x = 0; x < DISPLAY_WIDTH; x++) {
+      if (frame_pixel(frame, x, y)) {
+        image[y * ROW_BYTES + x / 8] |= 0x80 >> (x & 7);
+      }
+    }
+  }
+
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = fwrite(header, 1, sizeof(header) - 1, file) == sizeof(header) - 1 &&
+            fwrite(image, 1, sizeof(image), file) == sizeof(image);
+  return fclose(file) == 0 && ok;
+}
+
+bool pbm_read(const char *path, uint8_t *frame) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+
+  char head[sizeof(header) - 1];
+  uint8_t image[FRAME_BYTES];
+  bool ok = fread(head, 1, sizeof(head), file) == sizeof(head) &&
+            memcmp(head, header, sizeof(head)) == 0 &&
+            fread(image, 1, sizeof(image), file) == sizeof(image);
+  fclose(file);
+  if (!ok) {
+    return false;
+  }
+
+  memset(frame, 0, FRAME_BYTES);
+  for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+    for (int x = 0; x < DISPLAY_WIDTH; x++) {
+      if (image[y * ROW_BYTES + x / 8] & (0x80 >> (x & 7))) {
+        frame[(y / 8) * DISPLAY_WIDTH + x] |= 1 << (y & 7);
+      }
+    }
+  }
+  return true;
+}
+
+int pbm_diff_pixels(const uint8_t *a, const uint8_t *b) {
+  int count = 0;
+  for (int i = 0; i < FRAME_BYTES; i++) {
+    count += __builtin_popcount(a[i] ^ b[i]);
+  }
+  return count;
+}
@@ -0,0 +1,34 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - PBM Images
+ * =============================================================================
+ * Frames as binary PBM (P4) files, byte for byte the images the device
+ * serves at /display.pbm, so a golden image can be checked against a
+ * device as well.
+ * =============================================================================
+ */
+
+#ifndef PBM_H
+#define PBM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Write a frame in frame buffer layout as a PBM file
+ * @return false if the file could not be written
+ */
+bool pbm_write(const char *path, const uint8_t *frame);
+
+/**
+ * Read a PBM file written by pbm_write() into frame buffer layout
+ * @return false if the file is missing or not a 128x32 P4 image
+ */
+bool pbm_read(const char *path, uint8_t *frame);
+
+/**
+ * Count the pixels that differ between two frames
+ */
+int pbm_diff_pixels(const uint8_t *a, const uint8_t *b);
+
+#endif // PBM_H
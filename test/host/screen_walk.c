@@ -0,0 +1,190 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Screen Walk
+ * =============================================================================
+ */
+
+#include <stddef.h>
+
+#include "fake_devices.h"
+#include "screen_walk.h"
+#include "system_state.h"
+#include "ui_manager.h"
+
+// =============================================================================
+// Content
+// =============================================================================
+
+static const char file_text[] =
+    "Thermo notes\n"
+    "Q = m × c × ΔT for heating without a phase change. Water: "
+    "c = 4.18 J/(g·°C).\n"
+    "Latent heat: Q = m × L; the temperature stays put while the phase "
+    "changes.\n"
+    "First law: ΔU = Q − W, with W the work done by the gas.\n"
+    "Ideal gas: PV = nRT, R = 8.314 J/(mol·K). At constant temperature "
+    "the pressure is inversely proportional to the volume.\n"
+    "Efficiency of a heat engine: η = 1 − Tc/Th, temperatures in kelvin.";
+
+static const char ai_text[] =
+    "The derivative of sin(x) is cos(x), and the derivative of cos(x) is "
+    "−sin(x). Differentiating four times returns to where you started.";
+
+static const fake_chat_message_t chat[] = {
+    {"Don't forget the lab report is due Friday.", "WEB",
+     "2026-10-14T08:15:02.000Z"},
+    {"Thanks! Can you send the rubric?", "DEVICE",
+     "2026-10-14T08:16:40.000Z"},
+    {"Sent it to the file viewer — it's in the notes under “Lab 3”. The "
+     "discussion section is worth half the marks, so don't rush it.",
+     "WEB", "2026-10-14T08:21:11.000Z"},
+};
+
+// =============================================================================
+// Steps
+// =============================================================================
+
+typedef struct {
+  const char *name;
+  void (*run)(int arg);
+  int arg;
+} walk_step_t;
+
+static void press(int key) { host_ui_key((calx_key_t)key); }
+
+static void boot(int arg) {
+  fake_devices.file_text = file_text;
+  fake_devices.chat = chat;
+  fake_devices.chat_count = sizeof(chat) / sizeof(chat[0]);
+  system_state_set(STATE_BOOT);
+}
+
+static void not_bound(int arg) {
+  fake_devices.bound = false;
+  system_state_set(STATE_NOT_BOUND);
+}
+
+static void bind(int arg) {
+  system_state_set(STATE_BIND);
+  ui_manager_show_bind_code("4821");
+}
+
+static void idle(int arg) {
+  fake_devices.bound = true;
+  system_state_set(STATE_IDLE);
+}
+
+// Menu item by its number key, then its on-entry network work
+static void open_item(int key) {
+  press(key);
+  host_ui_network();
+}
+
+// Back to the menu from anywhere: idle, then any key
+static void to_menu(int arg) {
+  host_ui_long_key(KEY_AC);
+  press(KEY_OK);
+}
+
+static void search_the(int arg) {
+  static const calx_key_t keys[] = {KEY_DIVIDE, KEY_8, KEY_4, KEY_4,
+                                    KEY_3,      KEY_3};
+  for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+    press(keys[i]);
+  }
+}
+
+static void next_match(int arg) {
+  press(KEY_OK); // Close the bar, keeping the matches
+  press(KEY_RIGHT);
+}
+
+static void open_ai(int arg) {
+  to_menu(0);
+  press(KEY_3);
+  ui_manager_set_ai_response(ai_text, true);
+}
+
+static void open_settings(int arg) {
+  to_menu(0);
+  press(KEY_4);
+}
+
+// Settings page by its number, opened
+static void open_page(int page) {
+  to_menu(0);
+  press(KEY_4);
+  press(KEY_1 + page);
+  press(KEY_OK);
+}
+
+static void down_and_select(int times) {
+  for (int i = 0; i < times; i++) {
+    press(KEY_DOWN);
+  }
+  press(KEY_OK);
+}
+
+static void low_battery(int arg) { system_state_set(STATE_LOW_BATTERY); }
+
+static void ota(int arg) { ui_manager_show_ota_progress(42); }
+
+static void error(int arg) { ui_manager_show_error("Update Failed"); }
+
+static const walk_step_t steps[] = {
+    {"boot", boot},
+    {"not_bound", not_bound},
+    {"wifi_setup", press, KEY_OK},
+    {"bind", bind},
+    {"idle", idle},
+    {"menu", press, KEY_OK},
+    {"menu_right", press, KEY_RIGHT},
+    {"menu_down", press, KEY_DOWN},
+    {"chat", open_item, KEY_1},
+    {"chat_scroll", press, KEY_DOWN},
+    {"chat_older", press, KEY_DEL},
+    {"menu_back", press, KEY_AC},
+    {"file", open_item, KEY_2},
+    {"file_down", press, KEY_DOWN},
+    {"file_page", press, KEY_EQUALS},
+    {"file_search", search_the},
+    {"file_search_scroll", press, KEY_DOWN},
+    {"file_next_match", next_match},
+    {"ai", open_ai},
+    {"busy", press, KEY_OK},
+    {"settings", open_settings},
+    {"settings_down", press, KEY_DOWN},
+    {"settings_internet", open_page, 0},
+    {"settings_keyboard", open_page, 1},
+    {"settings_display", open_page, 2},
+    {"settings_text_size", press, KEY_RIGHT},
+    {"settings_power", open_page, 3},
+    {"settings_device", open_page, 4},
+    {"settings_unbind_confirm", down_and_select, 2},
+    {"settings_update", open_page, 5},
+    {"settings_advanced", open_page, 6},
+    {"debug_info", down_and_select, 2},
+    {"debug_info_close", press, KEY_AC},
+    {"settings_page_close", press, KEY_AC},
+    {"low_battery", low_battery},
+    {"ota", ota},
+    {"error", error},
+};
+
+// =============================================================================
+// Walk
+// =============================================================================
+
+void screen_walk(screen_walk_cb_t on_step, void *ctx) {
+  for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+    steps[i].run(steps[i].arg);
+
+    host_frame_t frame;
+    host_ui_frame(&frame);
+    host_ui_finish_transition(&frame);
+    on_step(steps[i].name, &frame, ctx);
+  }
+
+  // Leave the settings the walk changed as they were
+  fake_devices_reset();
+}
@@ -0,0 +1,30 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Screen Walk
+ * =============================================================================
+ * A fixed tour through every calx_state_t screen and the main views inside
+ * them, driven with keys the way a user would. Each step ends with a frame
+ * on the panel, handed to the caller under the step's name; a step that
+ * slides to another screen ends once the slide is over, and its frame
+ * covers every frame of the slide.
+ * =============================================================================
+ */
+
+#ifndef SCREEN_WALK_H
+#define SCREEN_WALK_H
+
+#include "host_ui.h"
+
+typedef void (*screen_walk_cb_t)(const char *name, const host_frame_t *frame,
+                                 void *ctx);
+
+/**
+ * Walk every step from the boot screen
+ * Can be repeated in the same process; later walks start from the caches
+ * (text layouts, chat history, metrics) the earlier ones left.
+ * @param on_step Called after each step's frame
+ * @param ctx Passed to on_step
+ */
+void screen_walk(screen_walk_cb_t on_step, void *ctx);
+
+#endif // SCREEN_WALK_H
@@ -0,0 +1,47 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - driver/i2c.h
+ * =============================================================================
+ * The legacy I2C master calls the display driver makes. The fake bus
+ * (fake_bus.c) implements them on top of an SSD1306 model.
+ * =============================================================================
+ */
+
+#ifndef HOST_DRIVER_I2C_H
+#define HOST_DRIVER_I2C_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int i2c_port_t;
+#define I2C_NUM_0 0
+
+typedef enum { I2C_MODE_SLAVE, I2C_MODE_MASTER } i2c_mode_t;
+
+#define GPIO_PULLUP_DISABLE 0
+#define GPIO_PULLUP_ENABLE 1
+
+typedef struct {
+  i2c_mode_t mode;
+  int sda_io_num;
+  int scl_io_num;
+  int sda_pullup_en;
+  int scl_pullup_en;
+  struct {
+    uint32_t clk_speed;
+  } master;
+  uint32_t clk_flags;
+} i2c_config_t;
+
+esp_err_t i2c_param_config(i2c_port_t port, const i2c_config_t *conf);
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode,
+                             size_t slv_rx_buf_len, size_t slv_tx_buf_len,
+                             int intr_alloc_flags);
+esp_err_t i2c_master_write_to_device(i2c_port_t port, uint8_t address,
+                                     const uint8_t *write_buffer,
+                                     size_t write_size,
+                                     TickType_t ticks_to_wait);
+
+#endif // HOST_DRIVER_I2C_H
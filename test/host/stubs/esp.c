@@ -0,0 +1,82 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - ESP-IDF Services
+ * =============================================================================
+ * Timer, logging, RNG and error names for the host build.
+ * =============================================================================
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "host_clock.h"
+
+// =============================================================================
+// Timer
+// =============================================================================
+
+int64_t esp_timer_get_time(void) { return (int64_t)host_clock_now_us(); }
+
+// =============================================================================
+// Logging
+// =============================================================================
+
+void esp_log_level_set(const char *tag, esp_log_level_t level) {}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format,
+                   ...) {
+  static int enabled = -1;
+  if (enabled < 0) {
+    enabled = getenv("CALX_HOST_LOG") != NULL;
+  }
+  if (!enabled) {
+    return;
+  }
+
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "[%s] ", tag);
+  vfprintf(stderr, format, args);
+  va_end(args);
+}
+
+// =============================================================================
+// Random Numbers
+// =============================================================================
+
+uint32_t esp_random(void) {
+  // xorshift32, fixed seed
+  static uint32_t state = 0x2545F491;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// =============================================================================
+// Errors
+// =============================================================================
+
+const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+  case ESP_OK:
+    return "ESP_OK";
+  case ESP_FAIL:
+    return "ESP_FAIL";
+  case ESP_ERR_NO_MEM:
+    return "ESP_ERR_NO_MEM";
+  case ESP_ERR_INVALID_ARG:
+    return "ESP_ERR_INVALID_ARG";
+  case ESP_ERR_INVALID_STATE:
+    return "ESP_ERR_INVALID_STATE";
+  case ESP_ERR_TIMEOUT:
+    return "ESP_ERR_TIMEOUT";
+  default:
+    return "UNKNOWN ERROR";
+  }
+}
@@ -0,0 +1,17 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - esp_random.h
+ * =============================================================================
+ * Host stand-in for the hardware RNG: a fixed-seed generator, so runs are
+ * repeatable.
+ * =============================================================================
+ */
+
+#ifndef HOST_ESP_RANDOM_H
+#define HOST_ESP_RANDOM_H
+
+#include <stdint.h>
+
+uint32_t esp_random(void);
+
+#endif // HOST_ESP_RANDOM_H
@@ -0,0 +1,18 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - esp_system.h
+ * =============================================================================
+ */
+
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include "esp_err.h"
+#include <stddef.h>
+
+/**
+ * Counted by the fake devices instead of restarting
+ */
+void esp_restart(void);
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,18 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - esp_timer.h
+ * =============================================================================
+ * Host stand-in for the ESP-IDF high resolution timer. It reads the
+ * simulated clock (host_clock.h), so times the firmware records do not
+ * depend on how fast the host runs.
+ * =============================================================================
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif // HOST_ESP_TIMER_H
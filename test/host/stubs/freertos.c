@@ -0,0 +1,305 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - FreeRTOS on POSIX Threads
+ * =============================================================================
+ * Semaphores are a count under a mutex and condition variable, queues a
+ * ring of items under one; task notifications are a per-task semaphore.
+ * Waits with a timeout block for that long in wall-clock time, while the
+ * tick count is the simulated clock.
+ * =============================================================================
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// =============================================================================
+// Simulated Clock
+// =============================================================================
+static _Atomic uint64_t clock_us = 0;
+
+void host_clock_advance_us(uint64_t us) { atomic_fetch_add(&clock_us, us); }
+
+uint64_t host_clock_now_us(void) { return atomic_load(&clock_us); }
+
+uint64_t host_clock_wall_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return (TickType_t)(host_clock_now_us() / (1000 * portTICK_PERIOD_MS));
+}
+
+void vTaskDelay(TickType_t ticks) {
+  host_clock_advance_us((uint64_t)ticks * 1000 * portTICK_PERIOD_MS);
+}
+
+// Wall-clock deadline for a wait of ticks, for pthread_cond_timedwait()
+static struct timespec deadline_after(TickType_t ticks) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  uint64_t ns = (uint64_t)deadline.tv_nsec +
+                (uint64_t)ticks * portTICK_PERIOD_MS * 1000000ull;
+  deadline.tv_sec += ns / 1000000000ull;
+  deadline.tv_nsec = ns % 1000000000ull;
+  return deadline;
+}
+
+// Wait on cond for up to ticks; false once the time is up
+static bool wait_for(pthread_cond_t *cond, pthread_mutex_t *lock,
+                     TickType_t ticks, const struct timespec *deadline) {
+  if (ticks == portMAX_DELAY) {
+    pthread_cond_wait(cond, lock);
+    return true;
+  }
+  return ticks != 0 &&
+         pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+// =============================================================================
+// Semaphores
+// =============================================================================
+struct host_semaphore {
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  uint32_t count;
+  uint32_t max;
+};
+
+static struct host_semaphore *semaphore_create(uint32_t count, uint32_t max) {
+  struct host_semaphore *sem = calloc(1, sizeof(*sem));
+  if (sem) {
+    pthread_mutex_init(&sem->lock, NULL);
+    pthread_cond_init(&sem->changed, NULL);
+    sem->count = count;
+    sem->max = max;
+  }
+  return sem;
+}
+
+// Wait until the count is non-zero and take from it; clear takes it all
+static uint32_t semaphore_take(struct host_semaphore *sem, TickType_t ticks,
+                               bool clear) {
+  struct timespec deadline = deadline_after(ticks);
+
+  pthread_mutex_lock(&sem->lock);
+  while (sem->count == 0 &&
+         wait_for(&sem->changed, &sem->lock, ticks, &deadline)) {
+  }
+
+  uint32_t taken = clear ? sem->count : (sem->count ? 1 : 0);
+  sem->count -= taken;
+  pthread_mutex_unlock(&sem->lock);
+  return taken;
+}
+
+static void semaphore_give(struct host_semaphore *sem) {
+  pthread_mutex_lock(&sem->lock);
+  if (sem->count < sem->max) {
+    sem->count++;
+  }
+  pthread_cond_broadcast(&sem->changed);
+  pthread_mutex_unlock(&sem->lock);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return semaphore_create(1, 1); }
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return semaphore_create(0, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore,
+                          TickType_t ticks_to_wait) {
+  return semaphore_take(semaphore, ticks_to_wait, false) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  semaphore_give(semaphore);
+  return pdTRUE;
+}
+
+// =============================================================================
+// Queues
+// =============================================================================
+struct host_queue {
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  uint8_t *items;
+  UBaseType_t length;
+  UBaseType_t item_size;
+  UBaseType_t head; // Next item to receive
+  UBaseType_t count;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  struct host_queue *queue = calloc(1, sizeof(*queue));
+  if (!queue) {
+    return NULL;
+  }
+  queue->items = calloc(length, item_size);
+  if (!queue->items) {
+    free(queue);
+    return NULL;
+  }
+  pthread_mutex_init(&queue->lock, NULL);
+  pthread_cond_init(&queue->changed, NULL);
+  queue->length = length;
+  queue->item_size = item_size;
+  return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item,
+                      TickType_t ticks_to_wait) {
+  struct timespec deadline = deadline_after(ticks_to_wait);
+
+  pthread_mutex_lock(&queue->lock);
+  while (queue->count == queue->length &&
+         wait_for(&queue->changed, &queue->lock, ticks_to_wait, &deadline)) {
+  }
+
+  BaseType_t sent = pdFALSE;
+  if (queue->count < queue->length) {
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->items[tail * queue->item_size], item, queue->item_size);
+    queue->count++;
+    pthread_cond_broadcast(&queue->changed);
+    sent = pdTRUE;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return sent;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item,
+                             BaseType_t *woken) {
+  if (woken) {
+    *woken = pdFALSE;
+  }
+  return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item,
+                         TickType_t ticks_to_wait) {
+  struct timespec deadline = deadline_after(ticks_to_wait);
+
+  pthread_mutex_lock(&queue->lock);
+  while (queue->count == 0 &&
+         wait_for(&queue->changed, &queue->lock, ticks_to_wait, &deadline)) {
+  }
+
+  BaseType_t received = pdFALSE;
+  if (queue->count > 0) {
+    memcpy(item, &queue->items[queue->head * queue->item_size],
+           queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    pthread_cond_broadcast(&queue->changed);
+    received = pdTRUE;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return received;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  pthread_mutex_lock(&queue->lock);
+  UBaseType_t count = queue->count;
+  pthread_mutex_unlock(&queue->lock);
+  return count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+  pthread_mutex_lock(&queue->lock);
+  queue->head = 0;
+  queue->count = 0;
+  pthread_cond_broadcast(&queue->changed);
+  pthread_mutex_unlock(&queue->lock);
+  return pdPASS;
+}
+
+// =============================================================================
+// Tasks
+// =============================================================================
+struct host_task {
+  pthread_t thread;
+  TaskFunction_t function;
+  void *arg;
+  struct host_semaphore *notify;
+};
+
+static _Thread_local struct host_task *current_task = NULL;
+
+static void *task_entry(void *arg) {
+  struct host_task *task = arg;
+  current_task = task;
+  task->function(task->arg);
+  return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name,
+                       uint32_t stack_depth, void *arg, UBaseType_t priority,
+                       TaskHandle_t *created) {
+  struct host_task *task = calloc(1, sizeof(*task));
+  if (!task) {
+    return pdFAIL;
+  }
+  task->function = function;
+  task->arg = arg;
+  task->notify = semaphore_create(0, UINT32_MAX);
+
+  if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+    free(task);
+    return pdFAIL;
+  }
+  pthread_detach(task->thread);
+  if (created) {
+    *created = task;
+  }
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task == NULL || task == current_task) {
+    pthread_exit(NULL);
+  }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  // Threads not made by xTaskCreate (the test's main thread) are adopted
+  if (!current_task) {
+    current_task = calloc(1, sizeof(*current_task));
+    current_task->thread = pthread_self();
+    current_task->notify = semaphore_create(0, UINT32_MAX);
+  }
+  return current_task;
+}
+
+// =============================================================================
+// Task Notifications
+// =============================================================================
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+  // Non-zero when notified; the callers only test that
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  return semaphore_take(self->notify, ticks_to_wait, clear_on_exit);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  semaphore_give(task->notify);
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+  semaphore_give(task->notify);
+  if (woken) {
+    *woken = pdTRUE;
+  }
+}
@@ -0,0 +1,39 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - freertos/FreeRTOS.h
+ * =============================================================================
+ * The subset of the FreeRTOS API the firmware uses, on POSIX threads
+ * (freertos.c). The tick rate matches sdkconfig (1000 Hz), and host code
+ * never runs in an ISR.
+ * =============================================================================
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "host_clock.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms) / portTICK_PERIOD_MS)
+#define pdTICKS_TO_MS(ticks) ((uint32_t)(ticks) * portTICK_PERIOD_MS)
+
+#define xPortInIsrContext() false
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+
+#endif // HOST_FREERTOS_H
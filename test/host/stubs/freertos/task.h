@@ -0,0 +1,37 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - freertos/task.h
+ * =============================================================================
+ * Tasks are threads; priorities and stack sizes are ignored. Ticks are
+ * the simulated clock, so xTaskGetTickCount() only moves when a test
+ * advances it or a task delays. Blocking calls with a timeout wait that
+ * long in wall-clock time.
+ * =============================================================================
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name,
+                       uint32_t stack_depth, void *arg, UBaseType_t priority,
+                       TaskHandle_t *created);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+TickType_t xTaskGetTickCount(void);
+
+/**
+ * Advance the simulated clock by ticks instead of sleeping
+ */
+void vTaskDelay(TickType_t ticks);
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+
+#endif // HOST_FREERTOS_TASK_H
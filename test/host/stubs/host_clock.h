@@ -0,0 +1,31 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Simulated Clock
+ * =============================================================================
+ * esp_timer_get_time() and xTaskGetTickCount() read this clock. It starts
+ * at zero and only moves when a test advances it or a task delays, so
+ * animations, timeouts and recorded times are the same on every run.
+ * =============================================================================
+ */
+
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+/**
+ * Advance the simulated clock
+ */
+void host_clock_advance_us(uint64_t us);
+
+/**
+ * Current simulated time in microseconds
+ */
+uint64_t host_clock_now_us(void);
+
+/**
+ * Wall-clock time in nanoseconds, for measuring how long host code runs
+ */
+uint64_t host_clock_wall_ns(void);
+
+#endif // HOST_CLOCK_H
@@ -0,0 +1,205 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Event Lanes
+ * =============================================================================
+ * Posts events of each lane in adverse orders and checks what
+ * event_manager_process() delivers: critical events first, then key
+ * presses, then coalesced and queued background events, with a critical
+ * event posted from a listener going next. Critical events must get through
+ * while both queues are full, and coalesced events must cancel a pending
+ * opposite and collapse repeats into one delivery.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+
+#include "event_manager.h"
+#include "logger.h"
+#include "system_state.h"
+
+#define MAX_RECORDED 64
+#define INPUT_QUEUE_SIZE 32      // As in event_manager.c
+#define BACKGROUND_QUEUE_SIZE 16 // As in event_manager.c
+
+typedef struct {
+  calx_event_type_t type;
+  int value;
+} recorded_t;
+
+static recorded_t recorded[MAX_RECORDED];
+static int recorded_count = 0;
+static int failures = 0;
+
+// Key whose press posts a critical event from the listener
+#define KEY_POSTS_CRITICAL KEY_9
+
+static void record(calx_event_t *event) {
+  if (recorded_count < MAX_RECORDED) {
+    recorded[recorded_count++] = (recorded_t){event->type, event->value};
+  }
+  if (event->type == EVENT_KEY_PRESS && event->key == KEY_POSTS_CRITICAL) {
+    event_manager_post_simple(EVENT_BIND_SUCCESS);
+  }
+}
+
+static void post(calx_event_type_t type, int value) {
+  calx_event_t event = {.type = type, .value = value};
+  if (!event_manager_post(&event)) {
+    printf("FAIL post of event %d refused\n", type);
+    failures++;
+  }
+}
+
+// Process everything pending and compare the deliveries with want
+static void expect(const char *name, const recorded_t *want, int count) {
+  recorded_count = 0;
+  event_manager_process();
+
+  bool same = recorded_count == count;
+  for (int i = 0; same && i < count; i++) {
+    same = recorded[i].type == want[i].type &&
+           recorded[i].value == want[i].value;
+  }
+  if (same) {
+    return;
+  }
+
+  printf("FAIL %s: delivered", name);
+  for (int i = 0; i < recorded_count; i++) {
+    printf(" %d:%d", recorded[i].type, recorded[i].value);
+  }
+  printf(", expected");
+  for (int i = 0; i < count; i++) {
+    printf(" %d:%d", want[i].type, want[i].value);
+  }
+  printf("\n");
+  failures++;
+}
+
+#define EXPECT(name, ...)                                                      \
+  do {                                                                         \
+    static const recorded_t want[] = {__VA_ARGS__};                            \
+    expect(name, want, sizeof(want) / sizeof(want[0]));                        \
+  } while (0)
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+// Posted lowest lane first, delivered highest first; FIFO within a queue
+static void test_drain_order(void) {
+  post(EVENT_API_SUCCESS, 1);
+  post(EVENT_WIFI_SCAN_DONE, 0);
+  post(EVENT_API_SUCCESS, 2);
+  post(EVENT_KEY_PRESS, KEY_1);
+  post(EVENT_KEY_PRESS, KEY_2);
+  post(EVENT_LOW_BATTERY, 0);
+
+  EXPECT("drain order", {EVENT_LOW_BATTERY, 0}, {EVENT_KEY_PRESS, KEY_1},
+         {EVENT_KEY_PRESS, KEY_2}, {EVENT_WIFI_SCAN_DONE, 0},
+         {EVENT_API_SUCCESS, 1}, {EVENT_API_SUCCESS, 2});
+}
+
+// A critical event posted while a key is dispatched overtakes the keys
+// still queued
+static void test_critical_from_listener(void) {
+  post(EVENT_API_SUCCESS, 1);
+  post(EVENT_KEY_PRESS, KEY_POSTS_CRITICAL);
+  post(EVENT_KEY_PRESS, KEY_2);
+
+  EXPECT("critical from listener", {EVENT_KEY_PRESS, KEY_POSTS_CRITICAL},
+         {EVENT_BIND_SUCCESS, 0}, {EVENT_KEY_PRESS, KEY_2},
+         {EVENT_API_SUCCESS, 1});
+}
+
+static void test_critical_with_full_queues(void) {
+  for (int i = 0; i < INPUT_QUEUE_SIZE; i++) {
+    post(EVENT_KEY_PRESS, KEY_1);
+  }
+  for (int i = 0; i < BACKGROUND_QUEUE_SIZE; i++) {
+    post(EVENT_API_SUCCESS, i);
+  }
+
+  // Both queues refuse more, after the short wait
+  if (event_manager_post_key(KEY_2, false)) {
+    printf("FAIL full input queue took another key\n");
+    failures++;
+  }
+  calx_event_t extra = {.type = EVENT_API_SUCCESS, .value = -1};
+  if (event_manager_post(&extra)) {
+    printf("FAIL full background queue took another event\n");
+    failures++;
+  }
+
+  post(EVENT_OTA_FAILED, 0);
+  post(EVENT_LOW_BATTERY, 0);
+
+  recorded_count = 0;
+  event_manager_process();
+  int keys = 0;
+  int background = 0;
+  for (int i = 2; i < recorded_count; i++) {
+    keys += recorded[i].type == EVENT_KEY_PRESS && i < 2 + INPUT_QUEUE_SIZE;
+    background += recorded[i].type == EVENT_API_SUCCESS &&
+                  recorded[i].value == i - 2 - INPUT_QUEUE_SIZE;
+  }
+  if (recorded_count != 2 + INPUT_QUEUE_SIZE + BACKGROUND_QUEUE_SIZE ||
+      recorded[0].type != EVENT_LOW_BATTERY ||
+      recorded[1].type != EVENT_OTA_FAILED || keys != INPUT_QUEUE_SIZE ||
+      background != BACKGROUND_QUEUE_SIZE) {
+    printf("FAIL full queues: %d delivered, first %d and %d, %d keys and %d "
+           "background in order\n",
+           recorded_count, recorded[0].type, recorded[1].type, keys,
+           background);
+    failures++;
+  }
+}
+
+static void test_coalescing(void) {
+  // Opposites cancel whichever is pending, in both directions
+  post(EVENT_LOW_BATTERY, 0);
+  post(EVENT_BATTERY_OK, 0);
+  EXPECT("battery ok cancels low", {EVENT_BATTERY_OK, 0});
+
+  post(EVENT_BATTERY_OK, 0);
+  post(EVENT_LOW_BATTERY, 0);
+  EXPECT("low cancels battery ok", {EVENT_LOW_BATTERY, 0});
+
+  post(EVENT_BIND_FAILED, 0);
+  post(EVENT_BIND_SUCCESS, 0);
+  post(EVENT_WIFI_CONNECTED, 0);
+  post(EVENT_WIFI_DISCONNECTED, 0);
+  EXPECT("bind and wifi opposites", {EVENT_BIND_SUCCESS, 0},
+         {EVENT_WIFI_DISCONNECTED, 0});
+
+  // Repeats are delivered once, without their payload
+  for (int i = 0; i < 5; i++) {
+    post(EVENT_LOW_BATTERY, i + 1);
+    post(EVENT_NEW_CHAT_MESSAGE, i + 1);
+  }
+  EXPECT("repeats", {EVENT_LOW_BATTERY, 0}, {EVENT_NEW_CHAT_MESSAGE, 0});
+
+  // Events that do not coalesce are all delivered
+  post(EVENT_API_SUCCESS, 1);
+  post(EVENT_API_SUCCESS, 1);
+  EXPECT("queued repeats", {EVENT_API_SUCCESS, 1}, {EVENT_API_SUCCESS, 1});
+}
+
+int main(void) {
+  static event_listener_t listeners[EVENT_TYPE_COUNT];
+
+  logger_init();
+  event_manager_init();
+  system_state_init(); // Key presses also go to the state machine
+  for (int type = EVENT_NONE + 1; type < EVENT_TYPE_COUNT; type++) {
+    event_manager_register(&listeners[type], type, record);
+  }
+
+  test_drain_order();
+  test_critical_from_listener();
+  test_critical_with_full_queues();
+  test_coalescing();
+
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
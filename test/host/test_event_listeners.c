@@ -0,0 +1,173 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Event Listeners
+ * =============================================================================
+ * Registers several listeners per event type and checks that a dispatch
+ * runs only that type's listeners, in registration order, and that
+ * registering a listener twice does nothing. A listener that unregisters
+ * itself while it runs must not stop the listeners after it from running
+ * in that dispatch, and must not run in the next one.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+
+#include "event_manager.h"
+#include "logger.h"
+#include "system_state.h"
+
+#define MAX_CALLS 16
+
+// Listener ids in the order they ran, over one event_manager_process()
+static int calls[MAX_CALLS];
+static int call_count = 0;
+static int failures = 0;
+
+typedef struct {
+  event_listener_t listener;
+  int id;
+  calx_event_type_t type;
+  bool unregister_self; // On its next run
+} test_listener_t;
+
+static void record_listener(test_listener_t *l) {
+  if (call_count < MAX_CALLS) {
+    calls[call_count++] = l->id;
+  }
+  if (l->unregister_self) {
+    l->unregister_self = false;
+    event_manager_unregister(&l->listener, l->type);
+  }
+}
+
+// One callback per listener, since callbacks are not passed their listener
+static test_listener_t listeners[4];
+
+static void run_0(calx_event_t *event) { record_listener(&listeners[0]); }
+static void run_1(calx_event_t *event) { record_listener(&listeners[1]); }
+static void run_2(calx_event_t *event) { record_listener(&listeners[2]); }
+static void run_3(calx_event_t *event) { record_listener(&listeners[3]); }
+
+static const event_callback_t callbacks[] = {run_0, run_1, run_2, run_3};
+
+static void add(int id, calx_event_type_t type) {
+  listeners[id].id = id;
+  listeners[id].type = type;
+  event_manager_register(&listeners[id].listener, type, callbacks[id]);
+}
+
+// Dispatch one event of type and compare the listeners run with want
+static void expect(const char *name, calx_event_type_t type, const int *want,
+                   int count) {
+  call_count = 0;
+  event_manager_post_simple(type);
+  event_manager_process();
+
+  bool same = call_count == count;
+  for (int i = 0; same && i < count; i++) {
+    same = calls[i] == want[i];
+  }
+  if (same) {
+    return;
+  }
+
+  printf("FAIL %s: ran", name);
+  for (int i = 0; i < call_count; i++) {
+    printf(" %d", calls[i]);
+  }
+  printf(", expected");
+  for (int i = 0; i < count; i++) {
+    printf(" %d", want[i]);
+  }
+  printf("\n");
+  failures++;
+}
+
+#define EXPECT(name, type, ...)                                                \
+  do {                                                                         \
+    static const int want[] = {__VA_ARGS__};                                   \
+    expect(name, type, want, sizeof(want) / sizeof(want[0]));                  \
+  } while (0)
+
+#define EXPECT_NONE(name, type) expect(name, type, NULL, 0)
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+static void test_order(void) {
+  add(2, EVENT_API_SUCCESS);
+  add(0, EVENT_API_SUCCESS);
+  add(3, EVENT_FILE_UPDATED);
+  add(1, EVENT_API_SUCCESS);
+  EXPECT("registration order", EVENT_API_SUCCESS, 2, 0, 1);
+  EXPECT("other type", EVENT_FILE_UPDATED, 3);
+  EXPECT_NONE("no listeners", EVENT_API_ERROR);
+
+  // Registering again neither moves the listener nor runs it twice
+  add(2, EVENT_API_SUCCESS);
+  add(0, EVENT_API_SUCCESS);
+  EXPECT("registered twice", EVENT_API_SUCCESS, 2, 0, 1);
+
+  // Unregistering from a type the listener is not registered for does
+  // nothing
+  event_manager_unregister(&listeners[3].listener, EVENT_API_SUCCESS);
+  event_manager_unregister(&listeners[0].listener, EVENT_FILE_UPDATED);
+  EXPECT("wrong type kept", EVENT_API_SUCCESS, 2, 0, 1);
+  EXPECT("wrong type kept", EVENT_FILE_UPDATED, 3);
+
+  // Unregistered (twice, the second doing nothing), then registered again
+  // at the back
+  event_manager_unregister(&listeners[2].listener, EVENT_API_SUCCESS);
+  EXPECT("unregistered", EVENT_API_SUCCESS, 0, 1);
+  event_manager_unregister(&listeners[2].listener, EVENT_API_SUCCESS);
+  add(2, EVENT_API_SUCCESS);
+  EXPECT("registered again", EVENT_API_SUCCESS, 0, 1, 2);
+}
+
+static void test_unregister_during_dispatch(void) {
+  // First, middle and last of the list each unregister themselves
+  for (int i = 0; i < 3; i++) {
+    int kept[2];
+    int n = 0;
+    for (int j = 0; j < 3; j++) {
+      if (j != i) {
+        kept[n++] = j;
+      }
+    }
+
+    listeners[i].unregister_self = true;
+    EXPECT("unregistering itself", EVENT_API_SUCCESS, 0, 1, 2);
+    expect("after unregistering itself", EVENT_API_SUCCESS, kept, 2);
+
+    // Put back in place, as 0, 1, 2
+    for (int j = i; j < 3; j++) {
+      event_manager_unregister(&listeners[j].listener, EVENT_API_SUCCESS);
+    }
+    for (int j = i; j < 3; j++) {
+      add(j, EVENT_API_SUCCESS);
+    }
+  }
+
+  // Every listener of the type unregisters itself in the same dispatch
+  for (int j = 0; j < 3; j++) {
+    listeners[j].unregister_self = true;
+  }
+  EXPECT("all unregistering", EVENT_API_SUCCESS, 0, 1, 2);
+  EXPECT_NONE("all unregistered", EVENT_API_SUCCESS);
+
+  // The other type's list is untouched
+  EXPECT("other type untouched", EVENT_FILE_UPDATED, 3);
+}
+
+int main(void) {
+  logger_init();
+  event_manager_init();
+  system_state_init();
+
+  test_order();
+  test_unregister_during_dispatch();
+
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Event Stress
+ * =============================================================================
+ * Four producer threads post numbered events into the background lane as
+ * fast as they can while the main thread consumes them the way the network
+ * task does (event_manager_wait(), then event_manager_process()). Posts
+ * that fail on a full lane are retried. Checks that every event arrives
+ * exactly once and in order per producer, and reports the throughput.
+ * =============================================================================
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "event_manager.h"
+#include "host_clock.h"
+#include "logger.h"
+
+#define PRODUCERS 4
+#define EVENTS_PER_PRODUCER 200000
+
+typedef struct {
+  int id;
+  uint32_t retries; // Posts refused by a full lane
+} producer_t;
+
+static uint32_t received[PRODUCERS]; // Next sequence number expected
+static uint32_t received_total = 0;
+static int failures = 0;
+
+static void *produce(void *arg) {
+  producer_t *producer = arg;
+
+  for (uint32_t seq = 0; seq < EVENTS_PER_PRODUCER; seq++) {
+    calx_event_t event = {.type = EVENT_API_SUCCESS,
+                          .value = (producer->id << 24) | seq};
+    while (!event_manager_post(&event)) {
+      producer->retries++;
+    }
+  }
+  return NULL;
+}
+
+static void on_event(calx_event_t *event) {
+  int id = event->value >> 24;
+  uint32_t seq = event->value & 0xFFFFFF;
+
+  if (id < 0 || id >= PRODUCERS) {
+    if (failures++ < 10) {
+      printf("FAIL event from unknown producer %d\n", id);
+    }
+    return;
+  }
+  if (seq != received[id]) {
+    if (failures++ < 10) {
+      printf("FAIL producer %d: got event %u, expected %u\n", id, seq,
+             received[id]);
+    }
+  }
+  received[id] = seq + 1;
+  received_total++;
+}
+
+int main(void) {
+  static event_listener_t listener;
+  static producer_t producers[PRODUCERS];
+  pthread_t threads[PRODUCERS];
+
+  logger_init();
+  event_manager_init();
+  event_manager_register(&listener, EVENT_API_SUCCESS, on_event);
+
+  uint64_t start = host_clock_wall_ns();
+  for (int i = 0; i < PRODUCERS; i++) {
+    producers[i].id = i;
+    pthread_create(&threads[i], NULL, produce, &producers[i]);
+  }
+
+  const uint32_t total = PRODUCERS * EVENTS_PER_PRODUCER;
+  while (received_total < total) {
+    event_manager_wait();
+    event_manager_process();
+  }
+  uint64_t elapsed = host_clock_wall_ns() - start;
+
+  uint32_t retries = 0;
+  for (int i = 0; i < PRODUCERS; i++) {
+    pthread_join(threads[i], NULL);
+    retries += producers[i].retries;
+    if (received[i] != EVENTS_PER_PRODUCER) {
+      printf("FAIL producer %d: %u of %u events arrived\n", i, received[i],
+             EVENTS_PER_PRODUCER);
+      failures++;
+    }
+  }
+
+  event_manager_process();
+  if (received_total != total) {
+    printf("FAIL %u events arrived, %u posted\n", received_total, total);
+    failures++;
+  }
+
+  printf("%d producers, %u events in %.1f ms: %.2f M events/s, "
+         "%u posts retried\n",
+         PRODUCERS, total, elapsed / 1e6, total / (elapsed / 1e3), retries);
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Flush Benchmark
+ * =============================================================================
+ * Runs the display driver against the fake bus clocked at 400 kHz, so each
+ * transaction takes as long as it would on the wire, and compares:
+ *   sync       each frame waits for its flush before the next is drawn
+ *   pipelined  the next frame is drawn while the previous one is on the bus
+ * Drawing is stood in for by a busy wait of a given length, since host
+ * render times say nothing about the ESP32's. Frames alternate between two
+ * screens that differ on every page, so every flush is a full frame.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_driver.h"
+#include "fake_bus.h"
+#include "host_clock.h"
+#include "logger.h"
+
+#define BUS_HZ 400000
+#define FRAMES 16
+
+static const uint32_t render_costs_us[] = {0, 2000, 5000, 10000};
+
+typedef struct {
+  double frame_ms;   // Wall time per frame, drawing included
+  double blocked_ms; // Time per frame the drawing task spent in the driver
+} bench_result_t;
+
+static void spin_us(uint32_t us) {
+  uint64_t end = host_clock_wall_ns() + (uint64_t)us * 1000;
+  while (host_clock_wall_ns() < end) {
+  }
+}
+
+static void draw_frame(int n, uint32_t render_us) {
+  display_driver_clear();
+  for (int line = 0; line < 4; line++) {
+    display_driver_draw_text(0, line * 8,
+                             (n & 1) ? "ABCDEFGHIJKLMNOPQRSTU"
+                                     : "abcdefghijklmnopqrstu",
+                             TEXT_SIZE_SMALL);
+  }
+  spin_us(render_us);
+}
+
+static bench_result_t run(uint32_t render_us, bool pipelined) {
+  uint64_t blocked = 0;
+  uint64_t start = host_clock_wall_ns();
+
+  for (int n = 0; n < FRAMES; n++) {
+    draw_frame(n, render_us);
+
+    uint64_t enter = host_clock_wall_ns();
+    display_driver_update();
+    if (!pipelined) {
+      display_driver_wait_flush(1000);
+    }
+    blocked += host_clock_wall_ns() - enter;
+  }
+  display_driver_wait_flush(1000);
+
+  uint64_t total = host_clock_wall_ns() - start;
+  return (bench_result_t){
+      .frame_ms = total / 1e6 / FRAMES,
+      .blocked_ms = blocked / 1e6 / FRAMES,
+  };
+}
+
+int main(void) {
+  int failures = 0;
+
+  logger_init();
+  display_driver_init();
+  fake_bus_set_speed(BUS_HZ);
+
+  printf("%-10s %12s %12s %12s %12s\n", "render ms", "sync fr ms",
+         "sync blk ms", "pipe fr ms", "pipe blk ms");
+
+  for (size_t i = 0; i < sizeof(render_costs_us) / sizeof(render_costs_us[0]);
+       i++) {
+    uint32_t cost = render_costs_us[i];
+    bench_result_t sync = run(cost, false);
+    bench_result_t pipe = run(cost, true);
+
+    printf("%-10.1f %12.2f %12.2f %12.2f %12.2f\n", cost / 1000.0,
+           sync.frame_ms, sync.blocked_ms, pipe.frame_ms, pipe.blocked_ms);
+
+    // Overlap can only help; allow for scheduling noise on a busy host
+    if (pipe.frame_ms > sync.frame_ms * 1.1) {
+      printf("FAIL pipelined frames slower than sync at %.1f ms render\n",
+             cost / 1000.0);
+      failures++;
+    }
+  }
+
+  uint8_t panel[FAKE_BUS_FRAME_BYTES];
+  fake_bus_read_panel(panel);
+  if (memcmp(panel, display_driver_get_buffer(), sizeof(panel)) != 0) {
+    printf("FAIL panel differs from the frame buffer\n");
+    failures++;
+  }
+
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Bytes per Frame
+ * =============================================================================
+ * Counts what each screen of the walk sends over I2C now that flushes only
+ * carry the changed spans of each page, and checks the panel still ends up
+ * showing exactly the frame buffer.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_driver.h"
+#include "screen_walk.h"
+#include "text_renderer.h"
+
+// Steps that move a selection or scroll within a screen; these must never
+// need a full frame
+static const char *const navigation_steps[] = {
+    "menu_right", "menu_down", "chat_scroll", "file_down", "settings_down",
+};
+
+typedef struct {
+  int failures;
+  uint32_t total_bytes;
+  uint32_t total_data;
+  int frames;
+} flush_bytes_t;
+
+static bool is_navigation(const char *name) {
+  for (size_t i = 0;
+       i < sizeof(navigation_steps) / sizeof(navigation_steps[0]); i++) {
+    if (strcmp(name, navigation_steps[i]) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void count_step(const char *name, const host_frame_t *frame,
+                       void *ctx) {
+  flush_bytes_t *test = ctx;
+  const fake_bus_counters_t *bus = &frame->bus;
+
+  printf("%-26s %6u %6u %6u %5.1f%%\n", name, bus->transactions, bus->bytes,
+         bus->data_bytes, 100.0 * bus->data_bytes / FAKE_BUS_FRAME_BYTES);
+
+  test->total_bytes += bus->bytes;
+  test->total_data += bus->data_bytes;
+  test->frames += frame->frames;
+
+  if (!frame->panel_matches) {
+    printf("FAIL %s: panel differs from the frame buffer\n", name);
+    test->failures++;
+  }
+  if (bus->data_bytes > FAKE_BUS_FRAME_BYTES * frame->frames) {
+    printf("FAIL %s: sent more than a full frame each time\n", name);
+    test->failures++;
+  }
+  if (is_navigation(name) && bus->data_bytes >= FAKE_BUS_FRAME_BYTES) {
+    printf("FAIL %s: navigation sent a full frame\n", name);
+    test->failures++;
+  }
+}
+
+// Flush the frame buffer as it stands and return the GDDRAM bytes it took
+static uint32_t flush_data_bytes(void) {
+  fake_bus_counters_t bus;
+
+  display_driver_wait_flush(1000);
+  fake_bus_reset_counters();
+  display_driver_update();
+  display_driver_wait_flush(1000);
+  fake_bus_get_counters(&bus);
+  return bus.data_bytes;
+}
+
+// Scroll text of every size back and forth, checking each render that
+// shifts the lines in place against drawing them from scratch, and that the
+// panel shows it without a full frame being sent
+static int check_text_scroll(void) {
+  static const char text[] =
+      "The display start line moves the rows that stay on screen, so a "
+      "scroll only sends the lines it exposes. Line heights that are not a "
+      "multiple of the eight row pages still scroll in place, the pages "
+      "they straddle being merged with what the panel already holds. Each "
+      "of these sentences wraps over a few lines at every size.";
+  static const calx_text_size_t sizes[] = {TEXT_SIZE_SMALL, TEXT_SIZE_NORMAL,
+                                           TEXT_SIZE_MEDIUM, TEXT_SIZE_LARGE};
+  static const int lines[] = {1, 2, 3, 2, 1, 0, 1};
+  uint8_t panel[FAKE_BUS_FRAME_BYTES];
+  uint8_t shifted[FAKE_BUS_FRAME_BYTES];
+  uint8_t fresh[FAKE_BUS_FRAME_BYTES];
+  int failures = 0;
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    text_renderer_set_content(text, sizeof(text) - 1, 0, sizes[s]);
+    text_renderer_render_content(0);
+    flush_data_bytes();
+
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+      text_renderer_render_content(lines[i]);
+      uint32_t sent = flush_data_bytes();
+      memcpy(shifted, display_driver_get_buffer(), FAKE_BUS_FRAME_BYTES);
+      host_ui_read_panel(panel);
+
+      text_renderer_invalidate();
+      text_renderer_render_content(lines[i]);
+      display_driver_save_frame(fresh);
+
+      if (memcmp(shifted, fresh, FAKE_BUS_FRAME_BYTES) != 0) {
+        printf("FAIL size %zu line %d: scrolled render differs\n", s,
+               lines[i]);
+        failures++;
+      }
+      if (memcmp(panel, shifted, FAKE_BUS_FRAME_BYTES) != 0) {
+        printf("FAIL size %zu line %d: panel differs\n", s, lines[i]);
+        failures++;
+      }
+      if (sent >= FAKE_BUS_FRAME_BYTES) {
+        printf("FAIL size %zu line %d: scroll sent a full frame\n", s,
+               lines[i]);
+        failures++;
+      }
+    }
+  }
+  return failures;
+}
+
+int main(void) {
+  flush_bytes_t test = {0};
+
+  host_ui_init();
+
+  printf("%-26s %6s %6s %6s %6s\n", "screen", "writes", "bytes", "data",
+         "frame");
+  screen_walk(count_step, &test);
+  printf("%-26s %6s %6u %6u %5.1f%%\n", "average", "",
+         test.total_bytes / test.frames, test.total_data / test.frames,
+         100.0 * test.total_data / test.frames / FAKE_BUS_FRAME_BYTES);
+
+  // The walk left a frame on the panel; sending it again costs nothing
+  uint32_t unchanged = flush_data_bytes();
+  if (unchanged != 0) {
+    printf("FAIL unchanged frame sent %u data bytes\n", unchanged);
+    test.failures++;
+  }
+
+  // One pixel changes one byte of one page
+  display_driver_set_pixel(70, 13, !(display_driver_get_buffer()[128 + 70] &
+                                     (1 << 5)));
+  uint32_t pixel = flush_data_bytes();
+  if (pixel != 1) {
+    printf("FAIL single pixel sent %u data bytes\n", pixel);
+    test.failures++;
+  }
+
+  test.failures += check_text_scroll();
+
+  printf("%s: %d failures\n", test.failures ? "FAIL" : "PASS", test.failures);
+  return test.failures ? 1 : 0;
+}
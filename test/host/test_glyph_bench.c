@@ -0,0 +1,146 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Glyph Benchmark
+ * =============================================================================
+ * Checks the column blitter in display_driver_draw_text() against a
+ * reference that sets each lit pixel with display_driver_set_pixel(), the
+ * way draw_char() used to, at every row offset within a page and every text
+ * size. Then reports glyphs per millisecond for both.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_driver.h"
+#include "fake_bus.h"
+#include "font.h"
+#include "host_clock.h"
+#include "logger.h"
+
+#define BENCH_ROUNDS 2000
+
+static const char sample[] = "The quick brown fox jumps";
+
+static const struct {
+  calx_text_size_t size;
+  const font_t *font;
+  const char *name;
+} sizes[] = {
+    {TEXT_SIZE_SMALL, &font_5x7, "small"},
+    {TEXT_SIZE_NORMAL, &font_6x8, "normal"},
+    {TEXT_SIZE_MEDIUM, &font_8x12, "medium"},
+    {TEXT_SIZE_LARGE, &font_12x16, "large"},
+};
+
+// Per-pixel reference for ASCII text, clipped the same way
+static void reference_draw_text(int x, int y, const char *text,
+                                const font_t *font) {
+  for (; *text; text++) {
+    int idx = *text - font->first_char;
+    if (x + font->advance[idx] > DISPLAY_WIDTH) {
+      break;
+    }
+
+    const uint8_t *glyph = &font->bitmap[font->offset[idx]];
+    int width = (font->offset[idx + 1] - font->offset[idx]) / font->pages;
+    for (int p = 0; p < font->pages; p++) {
+      for (int c = 0; c < width; c++) {
+        uint8_t bits = glyph[p * width + c];
+        for (int b = 0; b < 8; b++) {
+          if (bits & (1 << b)) {
+            display_driver_set_pixel(x + c, y + p * 8 + b, true);
+          }
+        }
+      }
+    }
+    x += font->advance[idx];
+  }
+}
+
+// Publish what was drawn and copy it out
+static void snapshot(uint8_t *out) {
+  display_driver_update();
+  display_driver_wait_flush(1000);
+  memcpy(out, display_driver_get_buffer(), FAKE_BUS_FRAME_BYTES);
+}
+
+static int check_identical(void) {
+  int failures = 0;
+  uint8_t fast[FAKE_BUS_FRAME_BYTES];
+  uint8_t slow[FAKE_BUS_FRAME_BYTES];
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    for (int y = -3; y < 12; y++) {
+      for (int x = -2; x < 3; x++) {
+        display_driver_clear();
+        display_driver_draw_text(x, y, sample, sizes[s].size);
+        snapshot(fast);
+
+        display_driver_clear();
+        reference_draw_text(x, y, sample, sizes[s].font);
+        snapshot(slow);
+
+        if (memcmp(fast, slow, sizeof(fast)) != 0) {
+          printf("FAIL %s text at (%d, %d) differs from the reference\n",
+                 sizes[s].name, x, y);
+          failures++;
+        }
+      }
+    }
+  }
+  return failures;
+}
+
+// Glyphs of the sample that fit on a line
+static int line_glyphs(const font_t *font) {
+  int x = 0;
+  int glyphs = 0;
+  for (const char *c = sample; *c; c++) {
+    x += font->advance[*c - font->first_char];
+    if (x > DISPLAY_WIDTH) {
+      break;
+    }
+    glyphs++;
+  }
+  return glyphs;
+}
+
+static double glyphs_per_ms(calx_text_size_t size, const font_t *font, int y,
+                            bool reference) {
+  uint64_t start = host_clock_wall_ns();
+
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    display_driver_clear();
+    if (reference) {
+      reference_draw_text(0, y, sample, font);
+    } else {
+      display_driver_draw_text(0, y, sample, size);
+    }
+  }
+
+  double ms = (host_clock_wall_ns() - start) / 1e6;
+  return (double)line_glyphs(font) * BENCH_ROUNDS / ms;
+}
+
+int main(void) {
+  logger_init();
+  display_driver_init();
+
+  int failures = check_identical();
+
+  printf("%-8s %-9s %14s %14s %8s\n", "size", "rows", "per-pixel/ms",
+         "blitter/ms", "speedup");
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    for (int y = 0; y < 2; y++) {
+      int row = y ? 3 : 8; // Page aligned, then split across pages
+      double slow = glyphs_per_ms(sizes[s].size, sizes[s].font, row, true);
+      double fast = glyphs_per_ms(sizes[s].size, sizes[s].font, row, false);
+      printf("%-8s %-9s %14.0f %14.0f %7.1fx\n", sizes[s].name,
+             y ? "unaligned" : "aligned", slow, fast, fast / slow);
+    }
+  }
+
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
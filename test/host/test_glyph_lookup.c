@@ -0,0 +1,206 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Glyph Lookup
+ * =============================================================================
+ * Checks UTF-8 decoding and that every extended code point draws its own
+ * glyph while unknown ones fall back to '?', then reports what a lookup
+ * costs per glyph: ASCII (direct index), extended (binary search over the
+ * sorted code points) and missing, alone and with decoding included.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_driver.h"
+#include "fake_bus.h"
+#include "font.h"
+#include "host_clock.h"
+#include "logger.h"
+#include "utf8.h"
+
+#define LOOKUPS 2000000
+#define MEASURES 20000
+
+static const struct {
+  calx_text_size_t size;
+  const font_t *font;
+  const char *name;
+} sizes[] = {
+    {TEXT_SIZE_SMALL, &font_5x7, "small"},
+    {TEXT_SIZE_NORMAL, &font_6x8, "normal"},
+    {TEXT_SIZE_MEDIUM, &font_8x12, "medium"},
+    {TEXT_SIZE_LARGE, &font_12x16, "large"},
+};
+
+static const char ascii_text[] = "Q = m x c x dT, c = 4.18 J/(g C) for water";
+static const char utf8_text[] = "Q = m × c × ΔT, c = 4.18 J/(g·°C) für Wasser";
+
+// =============================================================================
+// Checks
+// =============================================================================
+
+static int encode(uint32_t code, char *out) {
+  if (code < 0x80) {
+    out[0] = code;
+    out[1] = '\0';
+    return 1;
+  }
+  if (code < 0x800) {
+    out[0] = 0xC0 | (code >> 6);
+    out[1] = 0x80 | (code & 0x3F);
+    out[2] = '\0';
+    return 2;
+  }
+  out[0] = 0xE0 | (code >> 12);
+  out[1] = 0x80 | ((code >> 6) & 0x3F);
+  out[2] = 0x80 | (code & 0x3F);
+  out[3] = '\0';
+  return 3;
+}
+
+static int check_decoding(void) {
+  static const struct {
+    const char *text;
+    uint32_t codes[4];
+    int count;
+  } cases[] = {
+      {"A\xC3\xA9", {'A', 0xE9}, 2},
+      {"\xE2\x80\x94!", {0x2014, '!'}, 2},
+      {"\xC0\xAF", {UTF8_REPLACEMENT, UTF8_REPLACEMENT}, 2}, // Overlong
+      {"\xE2\x80", {UTF8_REPLACEMENT, UTF8_REPLACEMENT}, 2}, // Truncated
+      {"\xED\xA0\x80", {UTF8_REPLACEMENT, UTF8_REPLACEMENT, UTF8_REPLACEMENT},
+       3}, // Surrogate
+  };
+  int failures = 0;
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    const char *s = cases[i].text;
+    for (int n = 0; n < cases[i].count; n++) {
+      uint32_t code = *s ? utf8_next(&s) : 0;
+      if (code != cases[i].codes[n]) {
+        printf("FAIL case %zu decodes U+%04X at %d, expected U+%04X\n", i,
+               code, n, cases[i].codes[n]);
+        failures++;
+        break;
+      }
+    }
+    if (*s) {
+      printf("FAIL case %zu leaves bytes undecoded\n", i);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+static void render(const char *text, calx_text_size_t size, uint8_t *out) {
+  display_driver_clear();
+  display_driver_draw_text(0, 0, text, size);
+  display_driver_update();
+  display_driver_wait_flush(1000);
+  memcpy(out, display_driver_get_buffer(), FAKE_BUS_FRAME_BYTES);
+}
+
+static int check_glyphs(void) {
+  int failures = 0;
+  uint8_t missing[FAKE_BUS_FRAME_BYTES];
+  uint8_t frame[FAKE_BUS_FRAME_BYTES];
+  char text[4];
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    const font_t *font = sizes[s].font;
+    render("?", sizes[s].size, missing);
+
+    for (int i = 0; i < font->ext_count; i++) {
+      encode(font->ext_codes[i], text);
+      render(text, sizes[s].size, frame);
+      if (memcmp(frame, missing, sizeof(frame)) == 0) {
+        printf("FAIL %s U+%04X draws as '?'\n", sizes[s].name,
+               font->ext_codes[i]);
+        failures++;
+      }
+    }
+
+    encode(0x4E2D, text); // Not in any atlas
+    render(text, sizes[s].size, frame);
+    if (memcmp(frame, missing, sizeof(frame)) != 0) {
+      printf("FAIL %s missing code point does not draw as '?'\n",
+             sizes[s].name);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+// =============================================================================
+// Benchmarks
+// =============================================================================
+
+static volatile int sink;
+
+static double lookup_ns(const uint32_t *codes, int count) {
+  int total = 0;
+  uint64_t start = host_clock_wall_ns();
+  for (int i = 0; i < LOOKUPS; i++) {
+    total += display_driver_get_glyph_advance(codes[i % count],
+                                              TEXT_SIZE_NORMAL);
+  }
+  sink = total;
+  return (double)(host_clock_wall_ns() - start) / LOOKUPS;
+}
+
+// Decode and look up every glyph of a string, per glyph
+static double measure_ns(const char *text) {
+  int glyphs = 0;
+  for (const char *s = text; *s; glyphs++) {
+    utf8_next(&s);
+  }
+
+  int total = 0;
+  uint64_t start = host_clock_wall_ns();
+  for (int i = 0; i < MEASURES; i++) {
+    total += display_driver_get_text_width(text, TEXT_SIZE_NORMAL);
+  }
+  sink = total;
+  return (double)(host_clock_wall_ns() - start) / MEASURES / glyphs;
+}
+
+int main(void) {
+  logger_init();
+  display_driver_init();
+
+  int failures = check_decoding();
+  failures += check_glyphs();
+
+  static uint32_t ascii[95];
+  static uint32_t extended[512];
+  static uint32_t missing[256];
+  for (int i = 0; i < 95; i++) {
+    ascii[i] = ' ' + i;
+  }
+  int ext_count = font_6x8.ext_count;
+  for (int i = 0; i < ext_count; i++) {
+    extended[i] = font_6x8.ext_codes[i];
+  }
+  for (int i = 0; i < 256; i++) {
+    missing[i] = 0x4E00 + i;
+  }
+
+  printf("%-24s %10s\n", "lookup", "ns/glyph");
+  printf("%-24s %10.2f\n", "ascii", lookup_ns(ascii, 95));
+  printf("%-24s %10.2f\n", "extended", lookup_ns(extended, ext_count));
+  printf("%-24s %10.2f\n", "missing", lookup_ns(missing, 256));
+  printf("%-24s %10.2f\n", "decode+lookup ascii", measure_ns(ascii_text));
+  printf("%-24s %10.2f\n", "decode+lookup mixed", measure_ns(utf8_text));
+
+  printf("%-24s %10s\n", "font", "ext bytes");
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    const font_t *font = sizes[s].font;
+    int bytes = font->offset[font->glyph_count + font->ext_count] -
+                font->offset[font->glyph_count];
+    printf("%-24s %10d\n", sizes[s].name, bytes);
+  }
+
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,281 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Rectangle Benchmark
+ * =============================================================================
+ * Records the rectangles the menu and settings screens draw during the
+ * screen walk (the UI's calls into the rectangle primitives are wrapped at
+ * link time), replays them through the page-span kernels and through a
+ * per-pixel reference, checks both leave the same frame (for random
+ * rectangles as well) and reports how long each takes.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_driver.h"
+#include "esp_random.h"
+#include "host_clock.h"
+#include "screen_walk.h"
+
+#define MAX_RECTS 1024
+#define BENCH_ROUNDS 200
+
+typedef enum {
+  OP_FILL,
+  OP_CLEAR,
+  OP_INVERT,
+  OP_RECT,
+  OP_HLINE,
+  OP_VLINE,
+  OP_COUNT
+} rect_kind_t;
+
+static const char *const kind_names[OP_COUNT] = {
+    "fill", "clear", "invert", "rect", "hline", "vline",
+};
+
+typedef struct {
+  rect_kind_t kind;
+  int16_t x, y, width, height;
+} rect_call_t;
+
+static rect_call_t calls[MAX_RECTS];
+static int call_count = 0;
+static int step_start = 0; // First call recorded for the current step
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+void __real_display_driver_fill_rect(int x, int y, int width, int height,
+                                     bool on);
+void __real_display_driver_invert_rect(int x, int y, int width, int height);
+void __real_display_driver_draw_rect(int x, int y, int width, int height);
+void __real_display_driver_draw_hline(int x, int y, int width);
+void __real_display_driver_draw_vline(int x, int y, int height);
+
+static void record(rect_kind_t kind, int x, int y, int width, int height) {
+  if (call_count < MAX_RECTS) {
+    calls[call_count++] = (rect_call_t){kind, x, y, width, height};
+  }
+}
+
+void __wrap_display_driver_fill_rect(int x, int y, int width, int height,
+                                     bool on) {
+  record(on ? OP_FILL : OP_CLEAR, x, y, width, height);
+  __real_display_driver_fill_rect(x, y, width, height, on);
+}
+
+void __wrap_display_driver_invert_rect(int x, int y, int width, int height) {
+  record(OP_INVERT, x, y, width, height);
+  __real_display_driver_invert_rect(x, y, width, height);
+}
+
+void __wrap_display_driver_draw_rect(int x, int y, int width, int height) {
+  record(OP_RECT, x, y, width, height);
+  __real_display_driver_draw_rect(x, y, width, height);
+}
+
+void __wrap_display_driver_draw_hline(int x, int y, int width) {
+  record(OP_HLINE, x, y, width, 1);
+  __real_display_driver_draw_hline(x, y, width);
+}
+
+void __wrap_display_driver_draw_vline(int x, int y, int height) {
+  record(OP_VLINE, x, y, 1, height);
+  __real_display_driver_draw_vline(x, y, height);
+}
+
+// Keep only what the menu and settings screens drew
+static void keep_step(const char *name, const host_frame_t *frame,
+                      void *ctx) {
+  if (strncmp(name, "menu", 4) != 0 && strncmp(name, "settings", 8) != 0) {
+    call_count = step_start;
+  }
+  step_start = call_count;
+}
+
+// =============================================================================
+// Kernels and Reference
+// =============================================================================
+
+static void kernel_op(const rect_call_t *c) {
+  switch (c->kind) {
+  case OP_FILL:
+  case OP_CLEAR:
+    __real_display_driver_fill_rect(c->x, c->y, c->width, c->height,
+                                    c->kind == OP_FILL);
+    break;
+  case OP_INVERT:
+    __real_display_driver_invert_rect(c->x, c->y, c->width, c->height);
+    break;
+  case OP_RECT:
+    __real_display_driver_draw_rect(c->x, c->y, c->width, c->height);
+    break;
+  case OP_HLINE:
+    __real_display_driver_draw_hline(c->x, c->y, c->width);
+    break;
+  case OP_VLINE:
+    __real_display_driver_draw_vline(c->x, c->y, c->height);
+    break;
+  default:
+    break;
+  }
+}
+
+static uint8_t reference[FAKE_BUS_FRAME_BYTES];
+
+// One pixel at a time with bounds checks, as the primitives used to work
+static void reference_pixel(int x, int y, rect_kind_t kind) {
+  if (x < 0 || x >= DISPLAY_WIDTH || y < 0 || y >= DISPLAY_HEIGHT) {
+    return;
+  }
+  uint8_t *byte = &reference[x + (y / 8) * DISPLAY_WIDTH];
+  uint8_t bit = 1 << (y & 7);
+  if (kind == OP_INVERT) {
+    *byte ^= bit;
+  } else if (kind == OP_CLEAR) {
+    *byte &= ~bit;
+  } else {
+    *byte |= bit;
+  }
+}
+
+static void reference_area(int x, int y, int width, int height,
+                           rect_kind_t kind) {
+  for (int j = y; j < y + height; j++) {
+    for (int i = x; i < x + width; i++) {
+      reference_pixel(i, j, kind);
+    }
+  }
+}
+
+static void reference_op(const rect_call_t *c) {
+  if (c->kind == OP_RECT) {
+    reference_area(c->x, c->y, c->width, 1, OP_FILL);
+    reference_area(c->x, c->y + c->height - 1, c->width, 1, OP_FILL);
+    reference_area(c->x, c->y, 1, c->height, OP_FILL);
+    reference_area(c->x + c->width - 1, c->y, 1, c->height, OP_FILL);
+  } else if (c->kind == OP_HLINE) {
+    reference_area(c->x, c->y, c->width, 1, OP_FILL);
+  } else if (c->kind == OP_VLINE) {
+    reference_area(c->x, c->y, 1, c->height, OP_FILL);
+  } else {
+    reference_area(c->x, c->y, c->width, c->height, c->kind);
+  }
+}
+
+// =============================================================================
+// Checks
+// =============================================================================
+
+// Same noise in the driver's buffer and the reference, so clears and
+// inversions have something to act on
+static void seed_noise(void) {
+  display_driver_clear();
+  memset(reference, 0, sizeof(reference));
+  for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+    for (int x = 0; x < DISPLAY_WIDTH; x++) {
+      if (esp_random() & 1) {
+        display_driver_set_pixel(x, y, true);
+        reference_pixel(x, y, OP_FILL);
+      }
+    }
+  }
+}
+
+static int check_identical(void) {
+  int failures = 0;
+
+  seed_noise();
+  for (int i = 0; i < call_count; i++) {
+    kernel_op(&calls[i]);
+    reference_op(&calls[i]);
+  }
+  display_driver_update();
+  display_driver_wait_flush(1000);
+
+  if (memcmp(display_driver_get_buffer(), reference, sizeof(reference))) {
+    printf("FAIL recorded rectangles differ from the per-pixel reference\n");
+    failures++;
+  }
+
+  // Arbitrary rectangles too, partly off screen, for the edge cases the
+  // screens don't reach
+  seed_noise();
+  for (int i = 0; i < 2000; i++) {
+    rect_call_t c = {
+        .kind = esp_random() % OP_COUNT,
+        .x = (int)(esp_random() % 160) - 16,
+        .y = (int)(esp_random() % 48) - 8,
+        .width = esp_random() % 140,
+        .height = esp_random() % 40,
+    };
+    kernel_op(&c);
+    reference_op(&c);
+  }
+  display_driver_update();
+  display_driver_wait_flush(1000);
+
+  if (memcmp(display_driver_get_buffer(), reference, sizeof(reference))) {
+    printf("FAIL random rectangles differ from the per-pixel reference\n");
+    failures++;
+  }
+  return failures;
+}
+
+static void bench_kind(rect_kind_t kind) {
+  int count = 0;
+  for (int i = 0; i < call_count; i++) {
+    count += (calls[i].kind == kind);
+  }
+  if (count == 0) {
+    return;
+  }
+
+  uint64_t start = host_clock_wall_ns();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (int i = 0; i < call_count; i++) {
+      if (calls[i].kind == kind) {
+        reference_op(&calls[i]);
+      }
+    }
+  }
+  uint64_t slow = host_clock_wall_ns() - start;
+
+  start = host_clock_wall_ns();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (int i = 0; i < call_count; i++) {
+      if (calls[i].kind == kind) {
+        kernel_op(&calls[i]);
+      }
+    }
+  }
+  uint64_t fast = host_clock_wall_ns() - start;
+
+  double per = (double)count * BENCH_ROUNDS;
+  printf("%-8s %6d %14.1f %14.1f %7.1fx\n", kind_names[kind], count,
+         slow / per, fast / per, (double)slow / fast);
+}
+
+int main(void) {
+  host_ui_init();
+  screen_walk(keep_step, NULL);
+
+  int failures = 0;
+  if (call_count == 0) {
+    printf("FAIL no rectangles recorded\n");
+    failures++;
+  }
+  failures += check_identical();
+
+  printf("%-8s %6s %14s %14s %8s\n", "op", "calls", "per-pixel ns",
+         "kernel ns", "speedup");
+  for (int kind = 0; kind < OP_COUNT; kind++) {
+    bench_kind(kind);
+  }
+
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
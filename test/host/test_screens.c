@@ -0,0 +1,128 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Screen Golden Images
+ * =============================================================================
+ * Walks every screen and compares what the panel shows after each step
+ * with golden/<step>.pbm; any pixel of difference fails. The walk is then
+ * repeated to report how long each screen takes to render.
+ *
+ * Usage: test_screens <golden dir> [--update]
+ * --update rewrites the golden images from this build instead.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pbm.h"
+#include "screen_walk.h"
+
+#define TIMING_WALKS 25
+#define MAX_STEPS 64
+
+typedef struct {
+  const char *golden_dir;
+  bool update;
+  int failures;
+
+  // Render times per step, one column per timing walk
+  const char *names[MAX_STEPS];
+  uint64_t render_ns[MAX_STEPS][TIMING_WALKS];
+  int step;
+  int walk;
+} screens_t;
+
+static void check_step(const char *name, const host_frame_t *frame,
+                       void *ctx) {
+  screens_t *screens = ctx;
+
+  uint8_t panel[FAKE_BUS_FRAME_BYTES];
+  host_ui_read_panel(panel);
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.pbm", screens->golden_dir, name);
+
+  if (!frame->panel_matches) {
+    printf("FAIL %s: panel differs from the frame buffer\n", name);
+    screens->failures++;
+  }
+
+  if (screens->update) {
+    if (!pbm_write(path, panel)) {
+      printf("FAIL %s: cannot write %s\n", name, path);
+      screens->failures++;
+    }
+    return;
+  }
+
+  uint8_t golden[FAKE_BUS_FRAME_BYTES];
+  if (!pbm_read(path, golden)) {
+    printf("FAIL %s: no golden image at %s\n", name, path);
+    screens->failures++;
+    return;
+  }
+
+  int diff = pbm_diff_pixels(panel, golden);
+  if (diff) {
+    // Keep the image for inspection next to the binary
+    char actual[512];
+    snprintf(actual, sizeof(actual), "%s.actual.pbm", name);
+    pbm_write(actual, panel);
+    printf("FAIL %s: %d pixels differ from the golden image (see %s)\n",
+           name, diff, actual);
+    screens->failures++;
+  }
+}
+
+static void time_step(const char *name, const host_frame_t *frame,
+                      void *ctx) {
+  screens_t *screens = ctx;
+  if (screens->step < MAX_STEPS) {
+    screens->names[screens->step] = name;
+    screens->render_ns[screens->step][screens->walk] = frame->render_ns;
+  }
+  screens->step++;
+}
+
+static int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <golden dir> [--update]\n", argv[0]);
+    return 2;
+  }
+
+  static screens_t screens;
+  screens.golden_dir = argv[1];
+  screens.update = argc > 2 && strcmp(argv[2], "--update") == 0;
+
+  host_ui_init();
+  screen_walk(check_step, &screens);
+
+  for (screens.walk = 0; screens.walk < TIMING_WALKS; screens.walk++) {
+    screens.step = 0;
+    screen_walk(time_step, &screens);
+  }
+
+  printf("%-26s %10s %10s\n", "screen", "median us", "max us");
+  int steps = screens.step < MAX_STEPS ? screens.step : MAX_STEPS;
+  for (int i = 0; i < steps; i++) {
+    uint64_t *times = screens.render_ns[i];
+    qsort(times, TIMING_WALKS, sizeof(times[0]), compare_u64);
+    printf("%-26s %10.1f %10.1f\n", screens.names[i],
+           times[TIMING_WALKS / 2] / 1000.0,
+           times[TIMING_WALKS - 1] / 1000.0);
+  }
+
+  if (screens.update) {
+    printf("Golden images written to %s\n", screens.golden_dir);
+  }
+  printf("%s: %d failures\n", screens.failures ? "FAIL" : "PASS",
+         screens.failures);
+  return screens.failures ? 1 : 0;
+}
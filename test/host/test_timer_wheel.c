@@ -0,0 +1,241 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Timer Wheel
+ * =============================================================================
+ * Drives the timer wheel from the simulated clock, with the tick count
+ * starting just short of its 32-bit wrap. Thousands of one-shot timers
+ * spread over every level (and past the wheel's range) must each run once,
+ * in deadline order, in the first pass after their deadline, however far
+ * the clock jumps between passes. Stopped timers must never run, and
+ * periodic timers must re-arm one period (plus jitter) after each run.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host_clock.h"
+#include "logger.h"
+#include "timer_wheel.h"
+
+#define ONE_SHOTS 3000
+#define MAX_DELAY ((TickType_t)1 << 25) // Twice the wheel's 2^24 ticks
+#define START_BEFORE_WRAP ((TickType_t)1 << 22)
+
+typedef struct {
+  wheel_timer_t timer;
+  TickType_t expiry;
+  int runs;
+  bool stopped;
+} one_shot_t;
+
+static one_shot_t one_shots[ONE_SHOTS];
+static TickType_t last_expiry; // Of the last timer run in this pass
+static int failures = 0;
+
+static uint32_t next_random(void) {
+  static uint32_t state = 0x9E3779B9;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static void advance_ticks(TickType_t ticks) {
+  host_clock_advance_us((uint64_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+static void fail(const char *format, int index, TickType_t tick) {
+  if (failures++ < 10) {
+    printf(format, index, (unsigned)tick);
+  }
+}
+
+// =============================================================================
+// One-Shot Timers
+// =============================================================================
+
+static void run_one_shot(void *arg) {
+  one_shot_t *shot = arg;
+  int index = shot - one_shots;
+  TickType_t now = xTaskGetTickCount();
+
+  if (shot->stopped) {
+    fail("FAIL timer %d ran after being stopped (tick %u)\n", index, now);
+  }
+  if ((int32_t)(now - shot->expiry) < 0) {
+    fail("FAIL timer %d ran early (tick %u)\n", index, now);
+  }
+  if ((int32_t)(shot->expiry - last_expiry) < 0) {
+    fail("FAIL timer %d ran out of deadline order (tick %u)\n", index, now);
+  }
+  last_expiry = shot->expiry;
+  shot->runs++;
+}
+
+// Run a pass and check nothing that was due is left waiting
+static void process_and_check(void) {
+  last_expiry = xTaskGetTickCount() - MAX_DELAY;
+  timer_wheel_process();
+
+  TickType_t now = xTaskGetTickCount();
+  for (int i = 0; i < ONE_SHOTS; i++) {
+    one_shot_t *shot = &one_shots[i];
+    if (!shot->stopped && shot->runs == 0 &&
+        (int32_t)(now - shot->expiry) >= 0) {
+      fail("FAIL timer %d missed its deadline (tick %u)\n", i, now);
+      shot->runs = -1; // Reported once
+    }
+  }
+}
+
+// Advance in random jumps of up to max_step until the clock reaches end
+static void run_until(TickType_t end, TickType_t max_step) {
+  while ((int32_t)(end - xTaskGetTickCount()) > 0) {
+    TickType_t left = end - xTaskGetTickCount();
+    TickType_t step = 1 + next_random() % max_step;
+    advance_ticks(step < left ? step : left);
+    process_and_check();
+  }
+}
+
+static void test_one_shots(void) {
+  TickType_t start = xTaskGetTickCount();
+
+  for (int i = 0; i < ONE_SHOTS; i++) {
+    // Mostly short delays, with every level and the overflow represented
+    TickType_t delay = next_random() % (MAX_DELAY >> (next_random() % 20));
+    one_shots[i].expiry = start + delay;
+    timer_wheel_start(&one_shots[i].timer, delay * portTICK_PERIOD_MS, 0, 0,
+                      run_one_shot, &one_shots[i]);
+  }
+
+  // Jumps small enough to stop at most slots, then a little way in stop
+  // every third timer that has yet to run, wherever it has cascaded to
+  run_until(start + MAX_DELAY / 256, 1 << 10);
+  for (int i = 0; i < ONE_SHOTS; i += 3) {
+    if (one_shots[i].runs == 0) {
+      timer_wheel_stop(&one_shots[i].timer);
+      one_shots[i].stopped = true;
+    }
+  }
+  // Then long sleeps, leaving many cascades to catch up in one pass
+  run_until(start + MAX_DELAY + 1, 1 << 20);
+
+  int stopped = 0;
+  for (int i = 0; i < ONE_SHOTS; i++) {
+    one_shot_t *shot = &one_shots[i];
+    int expected = shot->stopped ? 0 : 1;
+    stopped += shot->stopped;
+    if (shot->runs != expected && shot->runs >= 0) {
+      printf("FAIL timer %d ran %d times, expected %d\n", i, shot->runs,
+             expected);
+      failures++;
+    }
+  }
+
+  // Stopping a timer that is not scheduled does nothing
+  timer_wheel_stop(&one_shots[0].timer);
+
+  printf("%d one-shot timers over %u ticks across the tick wrap, "
+         "%d stopped\n",
+         ONE_SHOTS, (unsigned)MAX_DELAY, stopped);
+}
+
+// =============================================================================
+// Periodic Timers
+// =============================================================================
+
+typedef struct {
+  wheel_timer_t timer;
+  TickType_t period;
+  TickType_t jitter;
+  TickType_t last_run;
+  int runs;
+  int stop_after; // Stops itself from its callback after this many runs
+  bool varied;    // Some interval was longer than the period
+} periodic_t;
+
+static void run_periodic(void *arg) {
+  periodic_t *p = arg;
+  TickType_t now = xTaskGetTickCount();
+
+  if (p->runs > 0) {
+    TickType_t interval = now - p->last_run;
+    if (interval < p->period || interval > p->period + p->jitter) {
+      printf("FAIL periodic timer (period %u, jitter %u) ran after %u "
+             "ticks\n",
+             (unsigned)p->period, (unsigned)p->jitter, (unsigned)interval);
+      failures++;
+    }
+    p->varied |= interval != p->period;
+  }
+  p->last_run = now;
+  p->runs++;
+
+  if (p->runs == p->stop_after) {
+    timer_wheel_stop(&p->timer);
+  }
+}
+
+static void test_periodic(void) {
+  periodic_t plain = {.period = 100};
+  periodic_t jittered = {.period = 100, .jitter = 20};
+  periodic_t self_stopping = {.period = 70, .stop_after = 3};
+  const TickType_t duration = 10000;
+
+  timer_wheel_start(&plain.timer, 50 * portTICK_PERIOD_MS,
+                    plain.period * portTICK_PERIOD_MS, 0, run_periodic,
+                    &plain);
+  timer_wheel_start(&jittered.timer, 0, jittered.period * portTICK_PERIOD_MS,
+                    jittered.jitter * portTICK_PERIOD_MS, run_periodic,
+                    &jittered);
+  timer_wheel_start(&self_stopping.timer, 0,
+                    self_stopping.period * portTICK_PERIOD_MS, 0,
+                    run_periodic, &self_stopping);
+
+  // A pass every tick, so every run lands exactly on its deadline
+  for (TickType_t t = 0; t < duration; t++) {
+    timer_wheel_process();
+    advance_ticks(1);
+  }
+  timer_wheel_stop(&plain.timer);
+  timer_wheel_stop(&jittered.timer);
+
+  // Runs at 50, 150, ... 9950
+  if (plain.runs != duration / plain.period) {
+    printf("FAIL periodic timer ran %d times, expected %u\n", plain.runs,
+           (unsigned)(duration / plain.period));
+    failures++;
+  }
+  if (plain.varied) {
+    printf("FAIL periodic timer without jitter drifted\n");
+    failures++;
+  }
+  if (jittered.runs < duration / (jittered.period + jittered.jitter) ||
+      !jittered.varied) {
+    printf("FAIL jittered timer ran %d times, varied %d\n", jittered.runs,
+           jittered.varied);
+    failures++;
+  }
+  if (self_stopping.runs != self_stopping.stop_after) {
+    printf("FAIL timer stopped from its callback ran %d times\n",
+           self_stopping.runs);
+    failures++;
+  }
+}
+
+int main(void) {
+  logger_init();
+
+  // Start the tick count short of its wrap, so deadlines wrap past zero
+  advance_ticks((TickType_t)0 - START_BEFORE_WRAP);
+  timer_wheel_init();
+
+  test_one_shots();
+  test_periodic();
+
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Trace Replay
+ * =============================================================================
+ * Records a session of key presses and outside transitions, dumps it in
+ * the /trace.bin format and replays the dump: it must reproduce in full.
+ * The same trace with one transition altered must stop at the event that
+ * made it.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_ui.h"
+#include "system_state.h"
+#include "trace_replay.h"
+
+#define DUMP_PATH "trace_replay_test.bin"
+
+static const struct {
+  calx_key_t key;
+  bool long_press;
+} session[] = {
+    {KEY_OK}, {KEY_1}, {KEY_AC}, {KEY_2},  {KEY_DOWN},
+    {KEY_AC, true},    {KEY_OK}, {KEY_4},  {KEY_AC},
+    {KEY_3},  {KEY_AC}, {KEY_9}, {KEY_AC, true},
+};
+
+// Write records from seq on as the device serves /trace.bin
+static bool dump(uint32_t first, const char *path) {
+  trace_header_t header = {
+      .magic = EVENT_TRACE_MAGIC,
+      .version = EVENT_TRACE_VERSION,
+      .record_size = sizeof(trace_record_t),
+      .first = first,
+      .count = event_trace_count() - first,
+  };
+
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  for (uint32_t seq = first; ok && seq != event_trace_count(); seq++) {
+    trace_record_t record;
+    ok = event_trace_get(seq, &record) &&
+         fwrite(&record, sizeof(record), 1, file) == 1;
+  }
+  return fclose(file) == 0 && ok;
+}
+
+int main(void) {
+  int failures = 0;
+
+  host_ui_init();
+
+  // Record a session
+  uint32_t first = event_trace_count();
+  system_state_set(STATE_IDLE);
+  for (size_t i = 0; i < sizeof(session) / sizeof(session[0]); i++) {
+    if (session[i].long_press) {
+      host_ui_long_key(session[i].key);
+    } else {
+      host_ui_key(session[i].key);
+    }
+    if (i == 5) {
+      // Battery monitor and network work change state outside the loop
+      system_state_set(STATE_LOW_BATTERY);
+      system_state_set(STATE_IDLE);
+    }
+  }
+
+  trace_record_t *records;
+  size_t count;
+  if (!dump(first, DUMP_PATH) ||
+      !trace_replay_load(DUMP_PATH, &records, &count)) {
+    printf("FAIL could not write and load the trace dump\n");
+    return 1;
+  }
+  remove(DUMP_PATH);
+
+  size_t matched = trace_replay(records, count);
+  printf("replayed %zu of %zu records\n", matched, count);
+  if (matched != count) {
+    printf("FAIL replay diverged at record %zu\n", matched);
+    failures++;
+  }
+
+  // Alter the first transition a key made; replay must stop at that key
+  size_t altered = count;
+  for (size_t i = 1; i < count; i++) {
+    if (records[i].type == EVENT_NONE && records[i].arg == EVENT_KEY_PRESS) {
+      altered = i;
+      break;
+    }
+  }
+  if (altered == count) {
+    printf("FAIL session made no transitions from keys\n");
+    failures++;
+  } else {
+    records[altered].to = STATE_ERROR;
+    size_t stop = trace_replay(records, count);
+    if (stop != altered - 1) {
+      printf("FAIL altered trace stopped at %zu, expected %zu\n", stop,
+             altered - 1);
+      failures++;
+    }
+  }
+
+  free(records);
+  printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+  return failures ? 1 : 0;
+}
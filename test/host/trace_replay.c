@@ -0,0 +1,122 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Trace Replay
+ * =============================================================================
+ * The trace keeps recording during replay; after each replayed event the
+ * records it wrote are read back and must equal the next ones in the trace
+ * (the event itself, then the transitions it made), timestamps aside.
+ * =============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_manager.h"
+#include "system_state.h"
+#include "trace_replay.h"
+
+// =============================================================================
+// Loading
+// =============================================================================
+
+bool trace_replay_load(const char *path, trace_record_t **records,
+                       size_t *count) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+
+  trace_header_t header;
+  bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+            memcmp(header.magic, EVENT_TRACE_MAGIC, 4) == 0 &&
+            header.version == EVENT_TRACE_VERSION &&
+            header.record_size == sizeof(trace_record_t);
+
+  *records = NULL;
+  *count = 0;
+  if (ok && header.count > 0) {
+    *records = malloc(header.count * sizeof(trace_record_t));
+    ok = *records && fread(*records, sizeof(trace_record_t), header.count,
+                           file) == header.count;
+    if (ok) {
+      *count = header.count;
+    } else {
+      free(*records);
+      *records = NULL;
+    }
+  }
+
+  fclose(file);
+  return ok;
+}
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+static bool same_record(const trace_record_t *a, const trace_record_t *b) {
+  return a->type == b->type && a->arg == b->arg && a->from == b->from &&
+         a->to == b->to;
+}
+
+// Compare the records written since seq with the trace from next on;
+// returns how far the trace now matches
+static size_t match_new(uint32_t seq, const trace_record_t *trace,
+                        size_t count, size_t next, bool *diverged) {
+  trace_record_t record;
+  for (; seq != event_trace_count(); seq++) {
+    if (next >= count || !event_trace_get(seq, &record) ||
+        !same_record(&record, &trace[next])) {
+      *diverged = true;
+      break;
+    }
+    next++;
+  }
+  return next;
+}
+
+size_t trace_replay(const trace_record_t *trace, size_t count) {
+  // Start in the state before the first transition
+  for (size_t i = 0; i < count; i++) {
+    if (trace[i].type == EVENT_NONE) {
+      system_state_set((calx_state_t)trace[i].from);
+      break;
+    }
+  }
+  event_manager_clear();
+
+  size_t next = 0;
+  bool diverged = false;
+  while (next < count && !diverged) {
+    const trace_record_t *record = &trace[next];
+    uint32_t seq = event_trace_count();
+
+    if (record->type == EVENT_NONE) {
+      // Transitions events made are matched while the event replays, so
+      // this one was not made, or not from this state
+      if (record->arg != EVENT_NONE || system_state_get() != record->from) {
+        break;
+      }
+      // Made outside the event loop: apply it
+      system_state_set((calx_state_t)record->to);
+      next = match_new(seq, trace, count, next, &diverged);
+      continue;
+    }
+
+    calx_event_t event = {.type = (calx_event_type_t)record->type};
+    if (record->type == EVENT_KEY_PRESS ||
+        record->type == EVENT_KEY_LONG_PRESS) {
+      event.key = (calx_key_t)record->arg;
+    }
+    event_manager_post(&event);
+    event_manager_process();
+
+    size_t at = next;
+    next = match_new(seq, trace, count, next, &diverged);
+    if (diverged) {
+      next = at; // This event went differently
+    }
+  }
+  return next;
+}
@@ -0,0 +1,43 @@
+/**
+ * =============================================================================
+ * CalX Host Tests - Trace Replay
+ * =============================================================================
+ * Replays an event trace (a /trace.bin dump, see event_trace.h) against the
+ * host build of the state machine, checking that every event makes the same
+ * transitions it made on the device.
+ * =============================================================================
+ */
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "event_trace.h"
+
+/**
+ * Load a trace dump
+ * @param path File written from /trace.bin
+ * @param records Set to the records, oldest first; free() them
+ * @param count Set to the number of records
+ * @return false if the file is missing, truncated or not a trace
+ */
+bool trace_replay_load(const char *path, trace_record_t **records,
+                       size_t *count);
+
+/**
+ * Replay a trace
+ * Starts from the state the trace starts in, then dispatches every event
+ * again, back to back, comparing the records it writes with the trace.
+ * Recorded transitions no event caused (network or boot) are applied as
+ * they come. Run it on a freshly initialized state machine: a trace from
+ * boot replays exactly, while one the ring has wrapped starts from menu
+ * positions it does not hold.
+ * @param records Trace records, oldest first
+ * @param count Number of records
+ * @return Number of records reproduced; count if the whole trace matched
+ */
+size_t trace_replay(const trace_record_t *records, size_t count);
+
+#endif // TRACE_REPLAY_H